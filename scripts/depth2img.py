@@ -11,19 +11,34 @@ logger = logging.getLogger("diffusers")
 
 # Load pipeline once for efficiency
 device = "cuda"
-pipe = StableDiffusionDepth2ImgPipeline.from_pretrained(
-    "stabilityai/stable-diffusion-2-depth",
-    torch_dtype=torch.float16,
-    use_safetensors=True,
-).to(device)
-
-# Replace the default scheduler with a DPM scheduler.
-# This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
-pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
-
-pipe.enable_sequential_cpu_offload()
-pipe.enable_xformers_memory_efficient_attention()
-pipe.enable_attention_slicing()
+pipe = None
+
+
+# Optional lifecycle hooks, see ScriptModel::callHook()
+def _load():
+    global pipe
+
+    pipe = StableDiffusionDepth2ImgPipeline.from_pretrained(
+        "stabilityai/stable-diffusion-2-depth",
+        torch_dtype=torch.float16,
+        use_safetensors=True,
+    ).to(device)
+
+    # Replace the default scheduler with a DPM scheduler.
+    # This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
+    pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
+
+    pipe.enable_sequential_cpu_offload()
+    pipe.enable_xformers_memory_efficient_attention()
+    pipe.enable_attention_slicing()
+
+
+def _unload():
+    global pipe
+    pipe = None
+    if torch.cuda.is_available():
+        torch.cuda.empty_cache()
+
 
 dlogging.set_verbosity_info()
 
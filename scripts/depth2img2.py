@@ -21,24 +21,39 @@ BASE_MODEL = "runwayml/stable-diffusion-v1-5"
 # ControlNet depth model (widely used)
 CONTROLNET_MODEL = "lllyasviel/sd-controlnet-depth"
 
-# Load ControlNet and pipeline
-controlnet = ControlNetModel.from_pretrained(
-    CONTROLNET_MODEL, torch_dtype=torch.float16
-)
+pipe = None
+
+
+# Optional lifecycle hooks, see ScriptModel::callHook()
+def _load():
+    global pipe
+
+    # Load ControlNet and pipeline
+    controlnet = ControlNetModel.from_pretrained(
+        CONTROLNET_MODEL, torch_dtype=torch.float16
+    )
+
+    pipe = StableDiffusionControlNetImg2ImgPipeline.from_pretrained(
+        BASE_MODEL,
+        controlnet=controlnet,
+        torch_dtype=torch.float16,
+        use_safetensors=True,
+    ).to(device)
+
+    # Replace scheduler with DPM solver
+    pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
+
+    pipe.enable_sequential_cpu_offload()
+    pipe.enable_xformers_memory_efficient_attention()
+    pipe.enable_attention_slicing()
 
-pipe = StableDiffusionControlNetImg2ImgPipeline.from_pretrained(
-    BASE_MODEL,
-    controlnet=controlnet,
-    torch_dtype=torch.float16,
-    use_safetensors=True,
-).to(device)
 
-# Replace scheduler with DPM solver
-pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
+def _unload():
+    global pipe
+    pipe = None
+    if torch.cuda.is_available():
+        torch.cuda.empty_cache()
 
-pipe.enable_sequential_cpu_offload()
-pipe.enable_xformers_memory_efficient_attention()
-pipe.enable_attention_slicing()
 
 dlogging.set_verbosity_info()
 
@@ -9,24 +9,39 @@ logger = logging.getLogger("diffusers")
 
 device = "cuda"
 
-# Load the pipeline correctly
-pipe = StableDiffusionPipeline.from_pretrained(
-    "runwayml/stable-diffusion-v1-5",
-    torch_dtype=torch.float16,
-    use_safetensors=True,
-    safety_checker=None
-).to(device)
-
-# Replace the default scheduler with a DPM scheduler.
-# This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
-pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
-
-pipe.enable_sequential_cpu_offload()
-pipe.enable_xformers_memory_efficient_attention()
-# Optional: Enable attention slicing (helps with memory usage) without quality loss.
-pipe.enable_attention_slicing()
-# Optional: For large image generation, you can also try VAE slicing.
-pipe.enable_vae_slicing()
+pipe = None
+
+
+# Optional lifecycle hooks, see ScriptModel::callHook()
+def _load():
+    global pipe
+
+    # Load the pipeline correctly
+    pipe = StableDiffusionPipeline.from_pretrained(
+        "runwayml/stable-diffusion-v1-5",
+        torch_dtype=torch.float16,
+        use_safetensors=True,
+        safety_checker=None
+    ).to(device)
+
+    # Replace the default scheduler with a DPM scheduler.
+    # This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
+    pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
+
+    pipe.enable_sequential_cpu_offload()
+    pipe.enable_xformers_memory_efficient_attention()
+    # Optional: Enable attention slicing (helps with memory usage) without quality loss.
+    pipe.enable_attention_slicing()
+    # Optional: For large image generation, you can also try VAE slicing.
+    pipe.enable_vae_slicing()
+
+
+def _unload():
+    global pipe
+    pipe = None
+    if torch.cuda.is_available():
+        torch.cuda.empty_cache()
+
 
 dlogging.set_verbosity_info()
 
@@ -7,22 +7,37 @@ from diffusers import logging as dlogging
 
 logger = logging.getLogger("diffusers")
 
-# Load once, move to GPU, enable memory optimizations
 device = "cuda"
-pipe = StableDiffusionImg2ImgPipeline.from_pretrained(
-    "runwayml/stable-diffusion-v1-5",
-    torch_dtype=torch.float16,
-    use_safetensors=True,
-).to(device)
+pipe = None
 
-# Replace the default scheduler with a DPM scheduler.
-# This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
-pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
 
+# Optional lifecycle hooks, see ScriptModel::callHook()
+def _load():
+    global pipe
+
+    # Move to GPU, enable memory optimizations
+    pipe = StableDiffusionImg2ImgPipeline.from_pretrained(
+        "runwayml/stable-diffusion-v1-5",
+        torch_dtype=torch.float16,
+        use_safetensors=True,
+    ).to(device)
+
+    # Replace the default scheduler with a DPM scheduler.
+    # This creates a DPMSolverMultistepScheduler instance with the same config as the pipeline's current scheduler.
+    pipe.scheduler = DPMSolverMultistepScheduler.from_config(pipe.scheduler.config, use_karras_sigmas=True)
+
+
+    pipe.enable_sequential_cpu_offload()
+    pipe.enable_xformers_memory_efficient_attention()
+    pipe.enable_attention_slicing()
+
+
+def _unload():
+    global pipe
+    pipe = None
+    if torch.cuda.is_available():
+        torch.cuda.empty_cache()
 
-pipe.enable_sequential_cpu_offload()
-pipe.enable_xformers_memory_efficient_attention()
-pipe.enable_attention_slicing()
 
 dlogging.set_verbosity_info()
 
@@ -15,15 +15,30 @@ logger = logging.getLogger("diffusers")
 device = "cuda"
 model_path = "runwayml/stable-diffusion-inpainting"
 
-pipe = StableDiffusionInpaintPipeline.from_pretrained(
-    model_path,
-    torch_dtype=torch.float16,
-).to(device)
-
-# Enable performance optimizations if supported.
-pipe.enable_sequential_cpu_offload()
-pipe.enable_xformers_memory_efficient_attention()
-pipe.enable_attention_slicing()
+pipe = None
+
+
+# Optional lifecycle hooks, see ScriptModel::callHook()
+def _load():
+    global pipe
+
+    pipe = StableDiffusionInpaintPipeline.from_pretrained(
+        model_path,
+        torch_dtype=torch.float16,
+    ).to(device)
+
+    # Enable performance optimizations if supported.
+    pipe.enable_sequential_cpu_offload()
+    pipe.enable_xformers_memory_efficient_attention()
+    pipe.enable_attention_slicing()
+
+
+def _unload():
+    global pipe
+    pipe = None
+    if torch.cuda.is_available():
+        torch.cuda.empty_cache()
+
 
 dlogging.set_verbosity_info()
 
@@ -3,6 +3,9 @@
 #include "datasingleton.h"
 
 #include "makeguard.h" 
+#include "floatrgb.h"
+#include "scriptworkerpool.h"
+#include "scriptworkerprotocol.h"
 
 #include "effects/scripteffect.h"
 #include "effects/scripteffectwithsettings.h"
@@ -17,9 +20,20 @@
 #include <QAction>
 #include <QMenu>
 #include <QProcess>
+#include <QSettings>
+#include <QHash>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QMutex>
 #include <QApplication>
 #include <QMessageBox>
 
+#include <vector>
+
 #undef slots
 
 #include <pybind11/embed.h>
@@ -29,6 +43,9 @@
 
 #ifdef Q_OS_WIN
 #include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
 #endif
 
 
@@ -48,101 +65,241 @@ void showErrorAsync(const QString& title, const QString& message) {
         Qt::QueuedConnection);
 }
 
-bool isPythonInstalled()
+const char PYTHON_CHECK_KEY[] = "/Python/ValidatedEnvironment";
+
+// Identifies the environment a successful probe belongs to: another Python,
+// a rebuilt application or a recreated virtual environment invalidate it.
+QString pythonEnvironmentKey(const QString& venvPath)
+{
+    QStringList parts;
+    parts << PY_VERSION << venvPath;
+    parts << QString::number(QFileInfo(QCoreApplication::applicationFilePath())
+        .lastModified().toMSecsSinceEpoch());
+    if (!venvPath.isEmpty())
+    {
+#ifdef Q_OS_WIN
+        const QFileInfo python(venvPath + "/Scripts/python.exe");
+#else
+        const QFileInfo python(venvPath + "/bin/python");
+#endif
+        parts << QString::number(python.lastModified().toMSecsSinceEpoch());
+    }
+    return parts.join('|');
+}
+
+// Starting a broken interpreter may abort the process, so it is tried in a
+// child process first. Successful results are remembered in the settings,
+// any result is remembered for the rest of this process.
+bool probePython(const QString& venvPath)
+{
+    static QMutex mutex;
+    static QHash<QString, bool> checked;
+
+    const QString key = pythonEnvironmentKey(venvPath);
+    QMutexLocker locker(&mutex);
+    auto it = checked.constFind(key);
+    if (it != checked.constEnd())
+        return it.value();
+
+    QSettings settings;
+    bool isInstalled = settings.value(PYTHON_CHECK_KEY).toString() == key;
+    if (!isInstalled)
+    {
+        const int status =
+            QProcess::execute(QCoreApplication::applicationFilePath(),
+                QStringList() << CHECK_PYTHON_OPTION);
+        isInstalled = status == 0;
+        if (isInstalled)
+            settings.setValue(PYTHON_CHECK_KEY, key);
+    }
+    checked.insert(key, isInstalled);
+    return isInstalled;
+}
+
+// Resident memory of this process, models of the embedded interpreter included.
+qint64 processMemoryUsage()
 {
-    const int status =
-        QProcess::execute(QCoreApplication::applicationFilePath(),
-            QStringList() << CHECK_PYTHON_OPTION);
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly))
+    {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return -1;
+}
 
-    return status == 0;
+// Bump when FunctionInfo serialization or introspection rules change.
+const quint32 FUNCTION_INFO_CACHE_VERSION = 1;
+
+// Descriptions of script functions are cached per script text and Python version.
+QString functionInfoCachePath(const QByteArray& scriptText)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(scriptText);
+    hash.addData(PY_VERSION);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+        + "/scripts/" + QString::fromLatin1(hash.result().toHex()) + ".info";
+}
+
+bool readFunctionInfos(const QString& cachePath, std::vector<FunctionInfo>& infos)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 version = 0, count = 0;
+    in >> version >> count;
+    if (version != FUNCTION_INFO_CACHE_VERSION)
+        return false;
+    std::vector<FunctionInfo> result;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        FunctionInfo info;
+        in >> info;
+        result.push_back(std::move(info));
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    infos = std::move(result);
+    return true;
+}
+
+void writeFunctionInfos(const QString& cachePath, const std::vector<FunctionInfo>& infos)
+{
+    QDir().mkpath(QFileInfo(cachePath).path());
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << FUNCTION_INFO_CACHE_VERSION << quint32(infos.size());
+    for (const FunctionInfo& info : infos)
+        out << info;
+    if (!file.commit())
+        qWarning() << "Failed to write script function cache" << cachePath;
 }
 
 //------------------------------------------------------------------------------
-// Converts a QImage to a contiguous pybind11::array (NumPy array).
-// The function ensures the QImage is in Format_RGB888 (3-channel format).
+// Exposes a QImage as a pybind11::array (NumPy array) of shape (height, width, 3)
+// without copying pixels: rows are addressed through bytesPerLine strides.
+// The array owns its own QImage reference through a capsule, so the pixels stay
+// valid for as long as Python holds the array.
 py::array qimage_to_nparray(const QImage& inImage) {
-    // Convert image to a well-defined RGB format.
-    QImage image = inImage.convertToFormat(QImage::Format_RGB888);
+    // Conversion to Format_RGB888 yields a private buffer; an image already in
+    // this format is shared with the caller and gets detached by bits() below,
+    // so that in-place writes of the script never leak into the canvas.
+    auto* holder = new QImage(inImage.convertToFormat(QImage::Format_RGB888));
+    py::capsule owner(holder, [](void* p) { delete static_cast<QImage*>(p); });
+    uchar* data = holder->bits();
 
-    int height = image.height();
-    int width = image.width();
     constexpr int channels = 3; // RGB
+    return py::array_t<uchar>(
+        { holder->height(), holder->width(), channels },
+        { static_cast<py::ssize_t>(holder->bytesPerLine()), static_cast<py::ssize_t>(channels), py::ssize_t(1) },
+        data, owner);
+}
 
-    // Allocate a new contiguous NumPy array with shape (height, width, 3).
-    py::array_t<uchar> arr({ height, width, channels });
-    py::buffer_info buf = arr.request();
-    uchar* dest = static_cast<uchar*>(buf.ptr);
+// References of released images waiting for a thread which holds the GIL.
+QMutex pendingReleasesMutex;
+std::vector<PyObject*> pendingReleases;
 
-    // Copy row-by-row to ensure a contiguous memory layout.
-    for (int i = 0; i < height; i++) {
-        const uchar* src = image.constScanLine(i);
-        std::memcpy(dest + i * (width * channels), src, width * channels);
+// Drops references queued by release_pyobject, the caller must hold the GIL.
+// Runs as a Python pending call and at the start of every script call.
+int release_pending_pyobjects(void* = nullptr) {
+    std::vector<PyObject*> objects;
+    {
+        QMutexLocker locker(&pendingReleasesMutex);
+        objects.swap(pendingReleases);
     }
-
-    return arr;
+    for (PyObject* object : objects)
+        Py_DECREF(object);
+    return 0;
 }
 
-uint8_t clip_uint8(long a) {
-    const uint8_t noOverflowCandidate = static_cast<uint8_t>(a);
-    return (noOverflowCandidate == a) ? noOverflowCandidate : ((noOverflowCandidate < a) ? UINT8_MAX : 0);
+// QImageCleanupFunction dropping the Python reference which keeps image data alive.
+// Images may be released on any thread, including one a script call waits for,
+// so the GIL is never waited for here: without it the reference is queued.
+void release_pyobject(void* info) {
+    auto* holder = static_cast<py::object*>(info);
+    PyObject* object = holder->release().ptr();
+    delete holder;
+    if (!Py_IsInitialized()) {
+        // Interpreter is gone along with the object, just forget the reference.
+        return;
+    }
+    if (PyGILState_Check()) {
+        Py_DECREF(object);
+        return;
+    }
+    {
+        QMutexLocker locker(&pendingReleasesMutex);
+        pendingReleases.push_back(object);
+    }
+    // May fail when Python's queue is full, the next script call drains it anyway.
+    Py_AddPendingCall(release_pending_pyobjects, nullptr);
 }
 
 //------------------------------------------------------------------------------
 // Converts a NumPy array (pybind11::array) back into a QImage.
-// The array must be contiguous and have shape (height, width, 3), dtype uint8.
+// The array must have shape (height, width, 3) or (3, height, width), dtype
+// uint8 or float32. uint8 arrays with packed pixels are wrapped without copying.
 QImage nparray_to_qimage(const py::array& a) {
     // Get buffer info.
     py::buffer_info info = a.request();
 
-    // Ensure the NumPy array has the correct shape and type.
-    if (info.ndim != 3 || info.shape[2] != 3) {
-        throw std::invalid_argument("nparray_to_qimage: Expected shape (height, width, 3)");
-    }
-
-    int height = static_cast<int>(info.shape[0]);
-    int width = static_cast<int>(info.shape[1]);
+    // Detect the layout from shape and strides: (height, width, 3) is HWC,
+    // (3, height, width) is CHW. Either may be a transposed view of the other,
+    // e.g. torch's permute(0, 2, 3, 1).numpy() keeps planar memory.
     constexpr int channels = 3;
+    FloatRgb::Layout layout;
+    if (info.ndim == 3 && info.shape[2] == channels) {
+        layout = { static_cast<int>(info.shape[1]), static_cast<int>(info.shape[0]),
+                   info.strides[0], info.strides[1], info.strides[2] };
+    }
+    else if (info.ndim == 3 && info.shape[0] == channels) {
+        layout = { static_cast<int>(info.shape[2]), static_cast<int>(info.shape[1]),
+                   info.strides[1], info.strides[2], info.strides[0] };
+    }
+    else {
+        throw std::invalid_argument("nparray_to_qimage: Expected shape (height, width, 3) or (3, height, width)");
+    }
 
-    // Create an empty QImage with Format_RGB888.
-    QImage image(width, height, QImage::Format_RGB888);
-
-    if (info.format == py::format_descriptor<uchar>::format()) {
-
-        // Copy row-by-row.
-        const uchar* src = static_cast<const uchar*>(info.ptr);
-        for (int i = 0; i < height; i++) {
-            uchar* dest = image.scanLine(i);
-            std::memcpy(dest, src + i * (width * channels), width * channels);
-        }
+    if (info.format == py::format_descriptor<float>::format()) {
+        // Samples in [0, 1] are scaled, rounded and saturated by SIMD kernels.
+        return FloatRgb::toRgb888(info.ptr, layout);
     }
-    else if (info.format == py::format_descriptor<float>::format()) 
-    {
-        // Convert floating-point values to uint8 (scale [0,1] -> [0,255])
-        /*
-        const float* src = static_cast<const float*>(info.ptr);
-        for (int i = 0; i < height; i++) {
-            uchar* dest = image.scanLine(i);
-            for (int j = 0; j < width * channels; j++) {
-                dest[j] = static_cast<uchar>(std::round(src[i * (width * channels) + j] * 255.0f));
-            }
-        }
-        */
-        const float* src = static_cast<const float*>(info.ptr);
-        for (int i = 0; i < height; i++) {
-            uchar* dest = image.scanLine(i);
-            for (int j = 0; j < width; j++) 
-                for (int k = 0; k < channels; ++k)
-                {
-                    dest[j * channels + k] = 
-                        clip_uint8(std::lround(src[k * (width * height) + i * width + j] * 255.0f));
-                }
-        }
+    if (info.format != py::format_descriptor<uchar>::format()) {
+        throw std::invalid_argument("nparray_to_qimage: Expected dtype=uint8 or dtype=float32");
     }
-    else
-    {
-        throw std::invalid_argument("nparray_to_qimage: Expected dtype=uint8");
+
+    if (layout.channelStride == 1 && layout.pixelStride == channels
+        && layout.rowStride >= static_cast<qsizetype>(layout.width) * channels) {
+        // Rows of RGB triplets can be wrapped as they are. The QImage is read-only
+        // and keeps the array alive until its last copy is gone; writing to it
+        // detaches a private copy.
+        return QImage(static_cast<const uchar*>(info.ptr), layout.width, layout.height,
+            layout.rowStride, QImage::Format_RGB888,
+            release_pyobject, new py::object(a));
     }
 
+    // Copy element-by-element following the strides of the view.
+    QImage image(layout.width, layout.height, QImage::Format_RGB888);
+    const uchar* src = static_cast<const uchar*>(info.ptr);
+    for (int i = 0; i < layout.height; i++) {
+        uchar* dest = image.scanLine(i);
+        const uchar* row = src + i * layout.rowStride;
+        for (int j = 0; j < layout.width; j++)
+            for (int k = 0; k < channels; ++k)
+                dest[j * channels + k] = row[j * layout.pixelStride + k * layout.channelStride];
+    }
     return image;
 }
 
@@ -239,9 +396,11 @@ bool send_image(const std::weak_ptr<EffectRunCallback>& mCallback, const pybind1
     {
         if (obj->isInterrupted())
             return false;
-        auto img = nparray_to_qimage(src);
-        //qDebug() << img;
-        emit obj->sendImage(img);
+        // Previous frame is still waiting for the GUI or came too recently:
+        // skip the conversion, a later step will send a fresher one.
+        if (!obj->isPreviewWanted())
+            return true;
+        obj->postImage(nparray_to_qimage(src));
         return true;
     }
     return false;
@@ -258,11 +417,18 @@ class ScriptModel::PythonScope
 // ----------------------------------------------------------------
 // ScriptModel implementation using pybind11 for embedding Python.
 
-ScriptModel::ScriptModel(QWidget* parent, const QString& venvPath)
+ScriptModel::ScriptModel(QWidget* parent, const QString& venvPath, int workerCount)
     : QObject(parent), mVenvPath(venvPath.trimmed())
 {
-    if (isPythonInstalled())
+    if (isPythonInstalled(mVenvPath))
     {
+        if (workerCount > 0)
+        {
+            // Interpreters live in the worker processes only
+            mWorkerPool = new ScriptWorkerPool(mVenvPath, workerCount, this);
+            mValid = true;
+            return;
+        }
         if (!mVenvPath.isEmpty())
         {
             // 1. Set VIRTUAL_ENV
@@ -294,6 +460,17 @@ ScriptModel::ScriptModel(QWidget* parent, const QString& venvPath)
             QObject::tr("Matching Python is not installed."),
             QObject::tr("Matching Python is not installed: ") + PY_VERSION
         );
+
+    // Models of the embedded interpreter are dropped after a quiet period
+    const int idleMinutes = DataSingleton::Instance()->getScriptIdleUnload();
+    if (mPythonScope && idleMinutes > 0)
+    {
+        mIdleUnloadMsec = qint64(idleMinutes) * 60 * 1000;
+        mIdleTimer = new QTimer(this);
+        mIdleTimer->setInterval(30 * 1000);
+        connect(mIdleTimer, SIGNAL(timeout()), this, SLOT(checkIdle()));
+        mIdleTimer->start();
+    }
 }
 
 void ScriptModel::LoadScript(const QString& path)
@@ -301,61 +478,48 @@ void ScriptModel::LoadScript(const QString& path)
     if (!mValid)
         return;
 
-    std::unique_lock<std::mutex> lock(mCallMutex);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open script" << path;
+        showErrorAsync(QObject::tr("Script Execution Error"),
+            QObject::tr("Error executing script: ") + file.errorString());
+        return;
+    }
+    const QByteArray scriptText = file.readAll();
+    const QString cachePath = functionInfoCachePath(scriptText);
+    const bool isCached = readFunctionInfos(cachePath, mFunctionInfos);
 
-    py::gil_scoped_acquire acquire;  // Ensures proper GIL acquisition
-    // Get the sys module and adjust sys.path.
-    py::module_ sys = py::module_::import("sys");
-    py::list sysPath = sys.attr("path");
-    qDebug() << "Python sys.path:" << QString::fromStdString(py::str(sysPath).cast<std::string>());
-    for (py::handle path_item : sysPath) {
-        std::string pathStr = py::str(path_item).cast<std::string>();
-        QString qpath = QString::fromStdString(pathStr) + "/site-packages";
-        if (QFileInfo::exists(qpath)) {
-            // Append path to sys.path if needed.
-            if (mVenvPath.isEmpty())
-                sys.attr("path").attr("append")(qpath.toStdString());
-#ifdef Q_OS_WIN
-            QString root = QFileInfo(QString::fromStdString(pathStr)).dir().path();
-            SetDllDirectoryW(reinterpret_cast<LPCWSTR>(root.utf16()));
-#endif
+    if (mWorkerPool)
+    {
+        // Workers find the same cache and defer their imports as well
+        mWorkerPool->start(path);
+        if (isCached)
+            return;
+        try {
+            mFunctionInfos = mWorkerPool->describe();
         }
+        catch (const std::exception& e) {
+            qWarning() << "Error loading script in worker:" << e.what();
+            showErrorAsync(QObject::tr("Script Execution Error"),
+                QObject::tr("Error executing script: ") + e.what());
+        }
+        return;
     }
 
-    if (!mVenvPath.isEmpty())
-        sys.attr("path").attr("insert")(0, (mVenvPath + "/Lib/site-packages").toStdString());
+    std::unique_lock<std::mutex> lock(mCallMutex);
+    mScriptText = scriptText;
+    if (isCached)
+    {
+        qDebug() << "Functions' info loaded from cache, script import is deferred.";
+        return;
+    }
 
-    // (Optional) Redirect Python stdout/stderr by reassigning sys.stdout/sys.stderr if desired.
+    py::gil_scoped_acquire acquire;  // Ensures proper GIL acquisition
+    const bool isImported = importScript();
 
-    // Get the __main__ module.
     py::module_ mainModule = py::module_::import("__main__");
     py::dict globals = mainModule.attr("__dict__");
 
-    // Inject functions into Python globals
-    globals["_send_image"] = py::cpp_function([this](const py::array& image) { 
-            send_image(mCallback, image);
-        });
-    globals["_check_interrupt"] = py::cpp_function([this]() { return check_interrupt(); });
-
-    // Execute an external script file.
-    // (Assuming "script.py" is accessibleadjust the path as needed.)
-    try {
-        // Load the script from Qt's resource system
-        QFile file(path);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            throw std::runtime_error("Failed to open script.py resource");
-        }
-
-        QTextStream in(&file);
-        auto text = in.readAll().toStdString();
-        py::eval<py::eval_statements>(text, globals);
-    }
-    catch (const std::exception& e) {
-        qWarning() << "Error executing script.py:" << e.what();
-        showErrorAsync(QObject::tr("Script Execution Error"),
-            QObject::tr("Error executing script: ") + e.what());
-    }
-
     py::module_ inspect = py::module_::import("inspect");
     // cache Parameter.empty
     py::object param_empty = inspect.attr("Parameter").attr("empty");
@@ -437,13 +601,115 @@ void ScriptModel::LoadScript(const QString& path)
         mFunctionInfos.push_back(std::move(info));
     }
     qDebug() << "All functions' info loaded.";
+
+    if (isImported)
+        writeFunctionInfos(cachePath, mFunctionInfos);
+}
+
+bool ScriptModel::importScript()
+{
+    // Get the sys module and adjust sys.path.
+    py::module_ sys = py::module_::import("sys");
+    py::list sysPath = sys.attr("path");
+    qDebug() << "Python sys.path:" << QString::fromStdString(py::str(sysPath).cast<std::string>());
+    for (py::handle path_item : sysPath) {
+        std::string pathStr = py::str(path_item).cast<std::string>();
+        QString qpath = QString::fromStdString(pathStr) + "/site-packages";
+        if (QFileInfo::exists(qpath)) {
+            // Append path to sys.path if needed.
+            if (mVenvPath.isEmpty())
+                sys.attr("path").attr("append")(qpath.toStdString());
+#ifdef Q_OS_WIN
+            QString root = QFileInfo(QString::fromStdString(pathStr)).dir().path();
+            SetDllDirectoryW(reinterpret_cast<LPCWSTR>(root.utf16()));
+#endif
+        }
+    }
+
+    if (!mVenvPath.isEmpty())
+        sys.attr("path").attr("insert")(0, (mVenvPath + "/Lib/site-packages").toStdString());
+
+    // (Optional) Redirect Python stdout/stderr by reassigning sys.stdout/sys.stderr if desired.
+
+    // Get the __main__ module.
+    py::module_ mainModule = py::module_::import("__main__");
+    py::dict globals = mainModule.attr("__dict__");
+
+    // Inject functions into Python globals
+    globals["_send_image"] = py::cpp_function([this](const py::array& image) { 
+            send_image(mCallback, image);
+        });
+    globals["_check_interrupt"] = py::cpp_function([this]() { return check_interrupt(); });
+
+    // Execute the script text read by LoadScript.
+    try {
+        py::eval<py::eval_statements>(mScriptText.toStdString(), globals);
+    }
+    catch (const std::exception& e) {
+        qWarning() << "Error executing script:" << e.what();
+        showErrorAsync(QObject::tr("Script Execution Error"),
+            QObject::tr("Error executing script: ") + e.what());
+        return false;
+    }
+    mIsImported = true;
+    return true;
 }
 
 ScriptModel::~ScriptModel() {
     mIsShuttingDown = true;
+    mUnloadFuture.waitForFinished();
     std::unique_lock<std::mutex> lock(mCallMutex);
 }
 
+bool ScriptModel::callHook(const char* name)
+{
+    py::module_ mainModule = py::module_::import("__main__");
+    py::dict globals = mainModule.attr("__dict__");
+    if (!globals.contains(name))
+        return true;
+
+    try {
+        globals[name]();
+    }
+    catch (const std::exception& e) {
+        qWarning() << "Error in script hook" << name << ":" << e.what();
+        showErrorAsync(QObject::tr("Python Call Error"),
+            QObject::tr("Error calling function ") + name + ": " + e.what());
+        return false;
+    }
+    return true;
+}
+
+void ScriptModel::checkIdle()
+{
+    // Never block the GUI thread: a running call keeps the mutex for minutes
+    if (mUnloadFuture.isRunning())
+        return;
+    mUnloadFuture = QtConcurrent::run([this] { unloadIfIdle(); });
+}
+
+void ScriptModel::unloadIfIdle()
+{
+    std::unique_lock<std::mutex> lock(mCallMutex, std::try_to_lock);
+    if (!lock.owns_lock() || mIsShuttingDown || !mIsLoaded
+            || mLastCallTimer.elapsed() < mIdleUnloadMsec)
+        return;
+
+    py::gil_scoped_acquire acquire;
+    release_pending_pyobjects();
+    py::module_ mainModule = py::module_::import("__main__");
+    py::dict globals = mainModule.attr("__dict__");
+    // Without the hook models are module globals, nothing can be released
+    if (!globals.contains("_unload"))
+        return;
+
+    qDebug() << "Script idle, calling _unload().";
+    callHook("_unload");
+    py::module_::import("gc").attr("collect")();
+    mIsLoaded = false;
+    emit stateChanged(false, processMemoryUsage());
+}
+
 void ScriptModel::setupActions(QMenu* fileMenu, QMenu* effectsMenu, QMap<int, QAction*>& effectsActMap)
 {
     if (!mValid)
@@ -495,9 +761,44 @@ QVariant ScriptModel::call(const QString& callable,
             return {};
     }
 
+    if (mWorkerPool)
+    {
+        // Workers run calls concurrently, no need to take mCallMutex
+        try {
+            return mWorkerPool->call(callable, args, callback, kwargs);
+        }
+        catch (const std::exception& e) {
+            qWarning() << "Error calling function" << callable << "in worker:" << e.what();
+            showErrorAsync(QObject::tr("Python Call Error"),
+                QObject::tr("Error calling function ") + callable + ": " + e.what());
+            return QVariant();
+        }
+    }
+
     std::unique_lock<std::mutex> lock(mCallMutex);
 
     py::gil_scoped_acquire acquire;  // Ensures proper GIL acquisition
+    release_pending_pyobjects();
+    // Menus may come from the cache, then the script is imported by its first call.
+    // A failed import was already reported, the function can't exist then.
+    if (!mIsImported && !importScript())
+        return QVariant();
+
+    auto idleGuard = MakeGuard(this, [](ScriptModel* pThis) {
+        pThis->mLastCallTimer.start();
+        emit pThis->stateChanged(pThis->mIsLoaded, processMemoryUsage());
+        });
+
+    // Heavy models are built by the optional _load() hook on demand,
+    // after _unload() dropped them on idle, the next call builds them again.
+    if (!mIsLoaded)
+    {
+        mCallback = callback;
+        if (!callHook("_load"))
+            return QVariant();
+        mIsLoaded = true;
+    }
+
     // Obtain the __main__ module and its globals.
     py::module_ mainModule = py::module_::import("__main__");
     py::dict globals = mainModule.attr("__dict__");
@@ -570,6 +871,11 @@ bool ScriptModel::check_interrupt()
     return true;
 }
 
+bool ScriptModel::isPythonInstalled(const QString& venvPath)
+{
+    return probePython(venvPath.trimmed());
+}
+
 int ScriptModel::ValidatePythonSystem() {
     //*
     try {
@@ -6,6 +6,8 @@
 
 #include <QObject>
 #include <QVariant>
+#include <QElapsedTimer>
+#include <QFuture>
 
 #include <vector>
 #include <memory>
@@ -13,6 +15,8 @@
 
 class QMenu;
 class QAction;
+class QTimer;
+class ScriptWorkerPool;
 
 
 const char CHECK_PYTHON_OPTION[] = "--checkPython";
@@ -22,26 +26,76 @@ class ScriptModel  : public QObject
     Q_OBJECT
 
 public:
-    ScriptModel(QWidget *parent, const QString& venvPath);
+    /**
+     * @param workerCount Number of worker processes running script functions,
+     * 0 to run them in the embedded interpreter.
+     */
+    ScriptModel(QWidget *parent, const QString& venvPath, int workerCount = 0);
     ~ScriptModel();
 
     void LoadScript(const QString& path);
 
+    const std::vector<FunctionInfo>& getFunctionInfos() const { return mFunctionInfos; }
+
     void setupActions(QMenu* fileMenu, QMenu* effectsMenu, QMap<int, QAction*>& effectsActMap);
 
     QVariant call(const QString& callable, const QVariantList& args = QVariantList(), std::weak_ptr<EffectRunCallback> callback = {}, const QVariantMap & kwargs = QVariantMap());
 
+    /**
+     * @brief Whether embedded Python can start with this environment.
+     *
+     * Probes a child process unless the environment was validated before, may
+     * be called from any thread.
+     */
+    static bool isPythonInstalled(const QString& venvPath);
     static int ValidatePythonSystem();
 
+signals:
+    /**
+     * @brief Script models were loaded or unloaded, or a call finished.
+     *
+     * @param isLoaded Whether _load() hook ran and _unload() was not called since.
+     * @param memoryBytes Resident memory of the process, -1 if unknown.
+     */
+    void stateChanged(bool isLoaded, qint64 memoryBytes);
+
+private slots:
+    void checkIdle();
+
 private:
     bool check_interrupt();
+    /**
+     * @brief Evaluates the script in __main__, called with mCallMutex and the GIL held.
+     */
+    bool importScript();
+    /**
+     * @brief Calls optional lifecycle hook of the script, with mCallMutex and the GIL held.
+     *
+     * Scripts may define two module level functions without arguments:
+     * _load() builds heavy state such as models, it runs before the first call
+     * and before the next call after an unload; _unload() drops that state when
+     * the script was idle, see checkIdle(), and gc.collect() runs after it.
+     * Without _unload() models stay loaded for the whole session.
+     *
+     * @return false if the hook raised.
+     */
+    bool callHook(const char* name);
+    void unloadIfIdle();
 
     bool mValid = false;
     std::weak_ptr<EffectRunCallback> mCallback;
     class PythonScope;
     std::unique_ptr<PythonScope> mPythonScope;
+    ScriptWorkerPool* mWorkerPool = nullptr;
     std::mutex mCallMutex;
     std::vector<FunctionInfo> mFunctionInfos;
+    QByteArray mScriptText;
+    bool mIsImported = false; /**< Script was evaluated, functions may be called. */
+    bool mIsLoaded = false; /**< Script _load() hook ran, models are in memory. */
+    QElapsedTimer mLastCallTimer; /**< Time since the last call ended, guarded by mCallMutex. */
+    qint64 mIdleUnloadMsec = 0;
+    QTimer* mIdleTimer = nullptr;
+    QFuture<void> mUnloadFuture;
     std::atomic_bool mIsShuttingDown = false;
 
     QString mVenvPath;
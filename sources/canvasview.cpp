@@ -0,0 +1,55 @@
+#include "canvasview.h"
+#include "imagearea.h"
+
+#include <QResizeEvent>
+#include <QScrollBar>
+
+CanvasView::CanvasView(ImageArea *imageArea, QWidget *parent) :
+    QAbstractScrollArea(parent), mImageArea(imageArea)
+{
+    setBackgroundRole(QPalette::Dark);
+    mImageArea->setParent(viewport());
+    mImageArea->setGeometry(viewport()->rect());
+    mImageArea->show();
+    horizontalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setSingleStep(20);
+
+    connect(mImageArea, SIGNAL(sendCanvasSizeChanged()), this, SLOT(updateScrollBars()));
+    updateScrollBars();
+}
+
+void CanvasView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    mImageArea->setGeometry(viewport()->rect());
+    updateScrollBars();
+}
+
+void CanvasView::scrollContentsBy(int, int)
+{
+    if (mIsUpdatingScrollBars)
+        return;
+    mImageArea->setScrollOffset(QPoint(horizontalScrollBar()->value(), verticalScrollBar()->value()));
+}
+
+void CanvasView::updateScrollBars()
+{
+    const QSize canvasSize = mImageArea->getCanvasSize();
+    const QSize viewSize = viewport()->size();
+    const QPoint offset = mImageArea->getScrollOffset();
+
+    // Offset is applied once below, not for every intermediate value
+    const bool wasUpdating = mIsUpdatingScrollBars;
+    mIsUpdatingScrollBars = true;
+    QScrollBar *horizontal = horizontalScrollBar();
+    QScrollBar *vertical = verticalScrollBar();
+    horizontal->setRange(0, qMax(0, canvasSize.width() - viewSize.width()));
+    horizontal->setPageStep(viewSize.width());
+    horizontal->setValue(offset.x());
+    vertical->setRange(0, qMax(0, canvasSize.height() - viewSize.height()));
+    vertical->setPageStep(viewSize.height());
+    vertical->setValue(offset.y());
+    mIsUpdatingScrollBars = wasUpdating;
+
+    mImageArea->setScrollOffset(QPoint(horizontal->value(), vertical->value()));
+}
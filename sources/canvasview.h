@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+
+class ImageArea;
+
+/**
+ * @brief Scrollable view of an image tab.
+ *
+ * Unlike QScrollArea it doesn't grow the image area to the zoomed image size:
+ * the area always fills the viewport and treats the zoomed image as a virtual
+ * surface, so paint and backing store cost depend on the window size only.
+ */
+class CanvasView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param imageArea Image area to show, the view takes ownership of it.
+     * @param parent Pointer for parent.
+     */
+    explicit CanvasView(ImageArea *imageArea, QWidget *parent = nullptr);
+
+    ImageArea *getImageArea() { return mImageArea; }
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private slots:
+    /**
+     * @brief Fit scroll bar ranges to zoomed image size and sync them with image area offset.
+     *
+     */
+    void updateScrollBars();
+
+private:
+    ImageArea *mImageArea;
+    bool mIsUpdatingScrollBars = false;
+};
@@ -0,0 +1,74 @@
+#include "cpufeatures.h"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define EASYPAINT_MSVC_X86
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EASYPAINT_GCC_X86
+#endif
+
+namespace {
+
+struct Features
+{
+    bool sse2 = false;
+    bool avx = false;
+    bool avx2 = false;
+
+    Features()
+    {
+#if defined(EASYPAINT_MSVC_X86)
+        int info[4] = {};
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        sse2 = (info[3] & (1 << 26)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        // AVX registers must also be saved by the OS on context switches
+        avx = osxsave && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        if (maxLeaf >= 7 && avx)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#elif defined(EASYPAINT_GCC_X86)
+        __builtin_cpu_init();
+        sse2 = __builtin_cpu_supports("sse2");
+        avx = __builtin_cpu_supports("avx");
+        avx2 = __builtin_cpu_supports("avx2");
+#endif
+    }
+};
+
+const Features &features()
+{
+    static const Features instance;
+    return instance;
+}
+
+std::atomic<int> maxLevel(CpuFeatures::AVX2);
+
+} // namespace
+
+bool CpuFeatures::hasSse2()
+{
+    return features().sse2 && maxLevel >= SSE2;
+}
+
+bool CpuFeatures::hasAvx()
+{
+    return features().avx && maxLevel >= AVX;
+}
+
+bool CpuFeatures::hasAvx2()
+{
+    return features().avx2 && maxLevel >= AVX2;
+}
+
+void CpuFeatures::setMaxLevel(Level level)
+{
+    maxLevel = level;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @brief Instruction sets supported by the running CPU.
+ *
+ * Used to choose between SIMD code paths at run time, so one binary
+ * works on every x86 machine; always false on other architectures.
+ */
+namespace CpuFeatures
+{
+    enum Level
+    {
+        SCALAR,
+        SSE2,
+        AVX,
+        AVX2
+    };
+
+    bool hasSse2();
+    bool hasAvx();
+    bool hasAvx2();
+
+    /**
+     * @brief Report no instruction sets above level, even if the CPU has them.
+     *
+     * Lets benchmarks and tests run slower code paths on a fast machine.
+     */
+    void setMaxLevel(Level level);
+}
@@ -78,6 +78,7 @@ void DataSingleton::readSetting()
     mIsAutoSave = settings.value("/Settings/IsAutoSave", false).toBool();
     mAutoSaveInterval = settings.value("/Settings/AutoSaveInterval", 300).toInt();
     mHistoryDepth = settings.value("/Settings/HistoryDepth", 40).toInt();
+    mHistoryMemoryLimit = settings.value("/Settings/HistoryMemoryLimit", 512).toInt();
     mAppLanguage = settings.value("/Settings/AppLanguage", "system").toString();
     mIsRestoreWindowSize = settings.value("/Settings/IsRestoreWindowSize", true).toBool();
     mIsAskCanvasSize = settings.value("/Settings/IsAskCanvasSize", true).toBool();
@@ -85,6 +86,9 @@ void DataSingleton::readSetting()
     mIsLoadScript = settings.value("/Settings/IsLoadScript", false).toBool();
     mScriptPath = settings.value("/Settings/ScriptPath").toString();
     mVirtualEnvironmentPath = settings.value("/Settings/VirtualEnvironmentPath").toString();
+    mPreviewMaxFps = settings.value("/Settings/PreviewMaxFps", 10).toInt();
+    mScriptWorkerCount = settings.value("/Settings/ScriptWorkerCount", 0).toInt();
+    mScriptIdleUnload = settings.value("/Settings/ScriptIdleUnload", 10).toInt();
 
     //read shortcuts for file menu
     mFileShortcuts.insert("New", settings.value("/Shortcuts/File/New", QKeySequence(QKeySequence::New)).value<QKeySequence>());
@@ -129,6 +133,7 @@ void DataSingleton::writeSettings()
     settings.setValue("/Settings/IsAutoSave", mIsAutoSave);
     settings.setValue("/Settings/AutoSaveInterval", mAutoSaveInterval);
     settings.setValue("/Settings/HistoryDepth", mHistoryDepth);
+    settings.setValue("/Settings/HistoryMemoryLimit", mHistoryMemoryLimit);
     settings.setValue("/Settings/AppLanguage", mAppLanguage);
     settings.setValue("/Settings/IsRestoreWindowSize", mIsRestoreWindowSize);
     settings.setValue("/Settings/IsDarkMode", mIsDarkMode);
@@ -136,6 +141,9 @@ void DataSingleton::writeSettings()
     settings.setValue("/Settings/IsLoadScript", mIsLoadScript);
     settings.setValue("/Settings/ScriptPath", mScriptPath);
     settings.setValue("/Settings/VirtualEnvironmentPath", mVirtualEnvironmentPath);
+    settings.setValue("/Settings/PreviewMaxFps", mPreviewMaxFps);
+    settings.setValue("/Settings/ScriptWorkerCount", mScriptWorkerCount);
+    settings.setValue("/Settings/ScriptIdleUnload", mScriptIdleUnload);
 
     //write shortcuts for file menu
     settings.setValue("/Shortcuts/File/New", mFileShortcuts["New"]);
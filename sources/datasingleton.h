@@ -61,6 +61,10 @@ public:
     void setSecondaryColor(const QColor &color) { mSecondaryColor = color; }
     int getPenSize() { return mPenSize; }
     void setPenSize(int size) { mPenSize = size; }
+    int getFillTolerance() { return mFillTolerance; }
+    void setFillTolerance(int tolerance) { mFillTolerance = tolerance; }
+    bool getIsFillEightConnected() { return mIsFillEightConnected; }
+    void setIsFillEightConnected(bool isEightConnected) { mIsFillEightConnected = isEightConnected; }
     InstrumentsEnum getInstrument() { return mCurrentInstrument; }
     void setInstrument(const InstrumentsEnum &instrument) { mCurrentInstrument = instrument; mIsResetCurve = true; }
     InstrumentsEnum getPreviousInstrument() { return mPreviousInstrument; }
@@ -73,6 +77,8 @@ public:
     void setAutoSaveInterval(int interval) { mAutoSaveInterval = interval; }
     int getHistoryDepth() { return mHistoryDepth; }
     void setHistoryDepth(const int &historyDepth) { mHistoryDepth = historyDepth; }
+    int getHistoryMemoryLimit() { return mHistoryMemoryLimit; }
+    void setHistoryMemoryLimit(int megabytes) { mHistoryMemoryLimit = megabytes; }
     QString getAppLanguage() { return mAppLanguage; }
     void setAppLanguage(const QString &appLanguage) { mAppLanguage = appLanguage; }
     bool getIsRestoreWindowSize() { return mIsRestoreWindowSize; }
@@ -89,6 +95,12 @@ public:
     void setVirtualEnvPath(const QString& virtualEnvironmentPath) { 
         mVirtualEnvironmentPath = virtualEnvironmentPath; 
     }
+    int getPreviewMaxFps() { return mPreviewMaxFps; }
+    void setPreviewMaxFps(int fps) { mPreviewMaxFps = fps; }
+    int getScriptWorkerCount() { return mScriptWorkerCount; }
+    void setScriptWorkerCount(int count) { mScriptWorkerCount = count; }
+    int getScriptIdleUnload() { return mScriptIdleUnload; }
+    void setScriptIdleUnload(int minutes) { mScriptIdleUnload = minutes; }
 
     QString getLastFilePath() { return mLastFilePath; }
     void setLastFilePath(const QString &lastFilePath) { mLastFilePath = lastFilePath; }
@@ -133,16 +145,22 @@ private:
     QColor mPrimaryColor,
            mSecondaryColor;
     int mPenSize;
+    int mFillTolerance = 0;
+    bool mIsFillEightConnected = false;
     InstrumentsEnum mCurrentInstrument, mPreviousInstrument;
     QSize mBaseSize, mWindowSize;
     bool mIsAutoSave, mIsRestoreWindowSize, mIsAskCanvasSize, mIsDarkMode;
     bool mIsLoadScript;
     QString mScriptPath;
     QString mVirtualEnvironmentPath;
+    int mPreviewMaxFps; /**< Limit of script preview frames shown per second */
+    int mScriptWorkerCount; /**< Processes running script functions, 0 - embedded interpreter */
+    int mScriptIdleUnload; /**< Minutes without calls before script _unload() hook, 0 - never */
 
     bool mIsResetCurve; /**< Needs to correct work of Bezier curve instrument */
     bool mMarkupMode = false;
     int mAutoSaveInterval, mHistoryDepth;
+    int mHistoryMemoryLimit; /**< Undo history of all tabs kept in memory, in megabytes */
     QString mAppLanguage;
     QString mLastFilePath; /* last opened file */
     QFont mTextFont;
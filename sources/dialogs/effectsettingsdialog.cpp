@@ -30,6 +30,9 @@
 
 #include "SpinnerOverlay.h"
 
+#include "../datasingleton.h"
+#include "../imageresize.h"
+
 #include <QVariant>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -51,6 +54,7 @@
 
 #include <QMainWindow>
 #include <QMessageBox>
+#include <QPointer>
 
 namespace {
 
@@ -93,21 +97,49 @@ class EffectSettingsDialog::FutureContext
     QMetaObject::Connection mImageConnection;
 
 public:
-    FutureContext(EffectSettingsDialog* dlg) : mainWindow(GetMainWindow()),
-        mEffectRunCallback(new EffectRunCallback(), std::mem_fn(&QObject::deleteLater))
+    /**
+     * @param isProxy Run on the downscaled proxy of the dialog instead of its source.
+     */
+    FutureContext(EffectSettingsDialog* dlg, bool isProxy = false) : mainWindow(GetMainWindow()),
+        mEffectRunCallback(new EffectRunCallback(DataSingleton::Instance()->getPreviewMaxFps()),
+            std::mem_fn(&QObject::deleteLater))
     {
-        QObject::connect(mEffectRunCallback.get(), &EffectRunCallback::sendImage, dlg, &EffectSettingsDialog::updatePreview);
+        // Frames are taken on arrival, so the worker skips building new ones until then
+        EffectRunCallback* callback = mEffectRunCallback.get();
+        QPointer<EffectSettingsDialog> dialog(dlg);
+        QObject::connect(callback, &EffectRunCallback::imageReady, callback, [callback, dialog, isProxy]() {
+            const QImage image = callback->takeImage();
+            if (!dialog || image.isNull())
+                return;
+            if (isProxy)
+                dialog->showProxyPreview(image);
+            else
+                dialog->updatePreview(image);
+            });
 
-        mFuture = QtConcurrent::run([this, dlg]() {
+        const QImage* source = isProxy ? &dlg->mProxyImage : dlg->mSourceImage;
+        const QImage* markup = isProxy
+            ? (dlg->mProxyMarkup.isNull() ? nullptr : &dlg->mProxyMarkup)
+            : dlg->mMarkupImage;
+        mFuture = QtConcurrent::run([this, dlg, source, markup]() {
             QImage result;
-            dlg->mEffectWithSettings->convertImage(dlg->mSourceImage, dlg->mMarkupImage, result, dlg->mSettingsWidget->getEffectSettings(),
+            dlg->mEffectWithSettings->convertImage(source, markup, result, dlg->mSettingsWidget->getEffectSettings(),
                 mEffectRunCallback);
             return result;
             }),
 
         watcher.setFuture(mFuture);
-        mImageConnection = QObject::connect(&watcher, &QFutureWatcher<QImage>::finished, dlg, [this, dlg]() {
-            dlg->updatePreview(watcher.result());
+        mImageConnection = QObject::connect(&watcher, &QFutureWatcher<QImage>::finished, dlg, [this, dlg, isProxy]() {
+            if (isProxy)
+            {
+                // The full resolution result may already be shown
+                if (!dlg->mFutureContext || !dlg->mFutureContext->isFinished())
+                    dlg->showProxyPreview(watcher.result());
+                if (dlg->mFutureContext)
+                    return;
+            }
+            else
+                dlg->updatePreview(watcher.result());
             dlg->mApplyButton->setEnabled(dlg->mApplyNeeded);
             dlg->mInterruptButton->setEnabled(false);
             });
@@ -203,6 +235,20 @@ EffectSettingsDialog::EffectSettingsDialog(const QImage* img, const QImage* mark
     hLayout_2->addWidget(mApplyButton);
     hLayout_2->addWidget(mInterruptButton);
 
+    // Effects that scale well are previewed on a copy of the preview size first
+    if (mSourceImage && effectWithSettings->isProxyPreviewSupported()
+        && (mSourceImage->width() > previewSize || mSourceImage->height() > previewSize))
+    {
+        const QSize proxySize = mSourceImage->size().scaled(previewSize, previewSize, Qt::KeepAspectRatio);
+        mProxyImage = ImageResize::resize(*mSourceImage, proxySize, ImageResize::FAST);
+        if (mMarkupImage && !mMarkupImage->isNull())
+            mProxyMarkup = ImageResize::resize(*mMarkupImage, proxySize, ImageResize::FAST);
+
+        mRefineCheckBox = new QCheckBox(tr("Refine at full resolution"), this);
+        mRefineCheckBox->setChecked(true);
+        hLayout_2->addWidget(mRefineCheckBox);
+    }
+
     QVBoxLayout *vLayout = new QVBoxLayout();
 
     vLayout->addLayout(hLayout_1);
@@ -226,18 +272,34 @@ void EffectSettingsDialog::updatePreview(const QImage& image) {
     {
         mImage = image;
         if (!mAccepted)
-        {
-            const bool shown = mShown;
-            mShown = true;
-            mPreviewScene->clear();
-            auto mPreviewPixmapItem = mPreviewScene->addPixmap(QPixmap::fromImage(image));
-            //mPreviewScene->setSceneRect(mPreviewPixmapItem->boundingRect());
-            if (!shown)
-            {
-                mPreviewView->fitInView(mPreviewPixmapItem, Qt::KeepAspectRatio);
-                zoomFactor = mPreviewView->transform().m11();  // Extract current scale from transformation
-            }
-        }
+            setPreviewPixmap(image, 1.);
+    }
+}
+
+void EffectSettingsDialog::showProxyPreview(const QImage& image)
+{
+    // Proxy is stretched over the scene area of the source, it is never the result
+    if (!isDummyImage(image) && !mAccepted && mSourceImage)
+        setPreviewPixmap(image, qreal(mSourceImage->width()) / image.width());
+}
+
+void EffectSettingsDialog::setPreviewPixmap(const QImage& image, qreal scale)
+{
+    const bool shown = mShown;
+    mShown = true;
+    if (mPreviewPixmapItem)
+        mPreviewPixmapItem->setPixmap(QPixmap::fromImage(image));
+    else
+    {
+        mPreviewPixmapItem = mPreviewScene->addPixmap(QPixmap::fromImage(image));
+        mPreviewPixmapItem->setTransformationMode(Qt::SmoothTransformation);
+    }
+    mPreviewPixmapItem->setScale(scale);
+    //mPreviewScene->setSceneRect(mPreviewPixmapItem->boundingRect());
+    if (!shown)
+    {
+        mPreviewView->fitInView(mPreviewPixmapItem, Qt::KeepAspectRatio);
+        zoomFactor = mPreviewView->transform().m11();  // Extract current scale from transformation
     }
 }
 
@@ -250,6 +312,10 @@ void EffectSettingsDialog::onParametersChanged()
 void EffectSettingsDialog::onInterrupt()
 {
     mInterruptButton->setEnabled(false);
+    if (mProxyContext && !mProxyContext->isFinished())
+        mProxyContext->interrupt();
+    mProxyContext.reset();
+    mFullRunNeeded = false;
     if (mFutureContext) {
         if (mFutureContext->isFinished())
             return;
@@ -267,7 +333,16 @@ void EffectSettingsDialog::applyMatrix()
         if (mFutureContext && !mFutureContext->isFinished()) {
             mFutureContext->interrupt();
         }
-        mFutureContext = std::make_unique<FutureContext>(this);
+        if (mProxyContext && !mProxyContext->isFinished()) {
+            mProxyContext->interrupt();
+        }
+        mProxyContext.reset();
+        mFutureContext.reset();
+        mFullRunNeeded = true;
+        if (!mProxyImage.isNull())
+            mProxyContext = std::make_unique<FutureContext>(this, true);
+        if (mProxyImage.isNull() || mRefineCheckBox->isChecked())
+            startFullRun();
         mApplyNeeded = false;
         mApplyButton->setEnabled(false);
         mInterruptButton->setEnabled(true);
@@ -275,8 +350,17 @@ void EffectSettingsDialog::applyMatrix()
     }
 }
 
+void EffectSettingsDialog::startFullRun()
+{
+    mFutureContext = std::make_unique<FutureContext>(this);
+    mFullRunNeeded = false;
+}
+
 QImage  EffectSettingsDialog::getChangedImage() 
 {
+    // The last Apply was previewed on the proxy only
+    if (mFullRunNeeded)
+        startFullRun();
     if (mFutureContext)
     {
         const auto image = mFutureContext->getResult(true);
@@ -289,7 +373,7 @@ QImage  EffectSettingsDialog::getChangedImage()
 
 void EffectSettingsDialog::accept()
 {
-    if (mApplyNeeded && !!mFutureContext)
+    if (mApplyNeeded && (mFutureContext || mProxyContext))
     {
         QMessageBox msgBox;
         msgBox.setWindowTitle(tr("Simulation Parameters Changed"));
@@ -28,6 +28,7 @@
 
 #include <QDialog>
 #include <QPushButton>
+#include <QCheckBox>
 
 #include <QWheelEvent>
 #include <QGraphicsView>
@@ -83,27 +84,37 @@ private:
     QPushButton *mCancelButton;
     QPushButton *mApplyButton;
     QPushButton* mInterruptButton;
+    QCheckBox* mRefineCheckBox = nullptr; /**< Whether Apply also runs at full resolution. */
 
     EffectWithSettings* mEffectWithSettings;
     AbstractEffectSettings *mSettingsWidget;
 
     QGraphicsView* mPreviewView;
     QGraphicsScene* mPreviewScene;
+    QGraphicsPixmapItem* mPreviewPixmapItem = nullptr; /**< Reused by every preview frame. */
     double zoomFactor = 1.;
 
     const QImage* mSourceImage;
     const QImage* mMarkupImage;
+    QImage mProxyImage; /**< Source downscaled to the preview, null if not used. */
+    QImage mProxyMarkup;
     QImage mImage;
 
     bool mApplyNeeded = true;
 
     class FutureContext;
-    std::unique_ptr<FutureContext> mFutureContext;
+    std::unique_ptr<FutureContext> mFutureContext; /**< Full resolution run. */
+    std::unique_ptr<FutureContext> mProxyContext;
+    bool mFullRunNeeded = false; /**< Last Apply ran on the proxy only. */
 
     bool mAccepted = false;
 
     bool mShown = false;
 
+    void showProxyPreview(const QImage& image);
+    void setPreviewPixmap(const QImage& image, qreal scale);
+    void startFullRun();
+
 private slots:
     void applyMatrix();
     void onParametersChanged();
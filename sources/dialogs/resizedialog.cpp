@@ -32,19 +32,20 @@
 #include <QtCore/QDebug>
 #include <QDialogButtonBox>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QGroupBox>
 #include <QVBoxLayout>
 
-ResizeDialog::ResizeDialog(const QSize &size, QWidget *parent) :
+ResizeDialog::ResizeDialog(const QSize &size, QWidget *parent, bool showResizeMode) :
     QDialog(parent), mWidth(size.width()), mHeight(size.height()),
     mOrigWidth(size.width()), mOrigHeight(size.height())
 {
-    initializeGui();
+    initializeGui(showResizeMode);
     layout()->setSizeConstraint(QLayout::SetFixedSize);
     setWindowTitle(tr("Resize"));
 }
 
-void ResizeDialog::initializeGui()
+void ResizeDialog::initializeGui(bool showResizeMode)
 {
     enum { MAX_COEFF = 8 };
 
@@ -110,6 +111,15 @@ void ResizeDialog::initializeGui()
     gLayout2->addWidget(label8, 1, 5);
     gLayout2->addWidget(mPreserveAspectBox, 2, 0, 1, 6);
 
+    if (showResizeMode)
+    {
+        mResizeModeBox = new QComboBox();
+        mResizeModeBox->addItem(tr("High quality (AVIR)"), ImageResize::QUALITY);
+        mResizeModeBox->addItem(tr("Fast (Lanczos)"), ImageResize::FAST);
+        gLayout2->addWidget(new QLabel(tr("Resampling:")), 3, 0);
+        gLayout2->addWidget(mResizeModeBox, 3, 1, 1, 5);
+    }
+
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok |
                                                        QDialogButtonBox::Cancel);
     connect(buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
@@ -129,6 +139,13 @@ void ResizeDialog::initializeGui()
     setLayout(mainLayout);
 }
 
+ImageResize::Mode ResizeDialog::getResizeMode()
+{
+    if (!mResizeModeBox)
+        return ImageResize::QUALITY;
+    return static_cast<ImageResize::Mode>(mResizeModeBox->currentData().toInt());
+}
+
 void ResizeDialog::pixelsButtonClicked(bool flag)
 {
     if(flag)
@@ -28,10 +28,13 @@
 
 #include <QDialog>
 
+#include "../imageresize.h"
+
 QT_BEGIN_NAMESPACE
 class QLabel;
 class QSpinBox;
 class QCheckBox;
+class QComboBox;
 QT_END_NAMESPACE
 
 /**
@@ -48,8 +51,9 @@ public:
      *
      * @param size Current image size.
      * @param parent Pointer for parent.
+     * @param showResizeMode Let user choose resampling quality (for image, not canvas).
      */
-    explicit ResizeDialog(const QSize &size, QWidget *parent);
+    explicit ResizeDialog(const QSize &size, QWidget *parent, bool showResizeMode = false);
 
     /**
      * @brief Return new image size
@@ -57,14 +61,21 @@ public:
      * @return QSize New size.
      */
     inline QSize getNewSize() { return QSize(mWidth, mHeight); }
+    /**
+     * @brief Return chosen resampling mode
+     *
+     * @return ImageResize::Mode Mode.
+     */
+    ImageResize::Mode getResizeMode();
     
 private:
-    void initializeGui();
+    void initializeGui(bool showResizeMode);
 
     QLabel *mNewSizeLabel; /**< Label for showing new size */
     QSpinBox *mPixelWButton, *mPixelHButton,
              *mPercentWButton, *mPercentHButton;
     QCheckBox *mPreserveAspectBox;
+    QComboBox *mResizeModeBox = nullptr;
     int mWidth, mHeight,
         mOrigWidth, mOrigHeight;
 
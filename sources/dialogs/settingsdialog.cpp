@@ -131,10 +131,16 @@ QGroupBox* SettingsDialog::createImageSettings() {
 
     QLabel* labelHistoryDepth = new QLabel(tr("History depth:"));
     mHistoryDepth = new QSpinBox();
-    mHistoryDepth->setRange(1, 99);
+    mHistoryDepth->setRange(1, 999);
     mHistoryDepth->setValue(DataSingleton::Instance()->getHistoryDepth());
     mHistoryDepth->setFixedWidth(80);
 
+    QLabel* labelHistoryMemoryLimit = new QLabel(tr("History memory limit (MB):"));
+    mHistoryMemoryLimit = new QSpinBox();
+    mHistoryMemoryLimit->setRange(16, 65536);
+    mHistoryMemoryLimit->setValue(DataSingleton::Instance()->getHistoryMemoryLimit());
+    mHistoryMemoryLimit->setFixedWidth(80);
+
     mIsAutoSave = new QCheckBox(tr("Autosave interval (sec):"));
     mIsAutoSave->setChecked(DataSingleton::Instance()->getIsAutoSave());
 
@@ -149,9 +155,11 @@ QGroupBox* SettingsDialog::createImageSettings() {
     gridLayout->addLayout(sizeLayout, 0, 1);
     gridLayout->addWidget(labelHistoryDepth, 1, 0);
     gridLayout->addWidget(mHistoryDepth, 1, 1);
-    gridLayout->addWidget(mIsAutoSave, 2, 0);
-    //gridLayout->addWidget(labelAutoSave, 3, 0);
-    gridLayout->addWidget(mAutoSaveInterval, 2, 1);
+    gridLayout->addWidget(labelHistoryMemoryLimit, 2, 0);
+    gridLayout->addWidget(mHistoryMemoryLimit, 2, 1);
+    gridLayout->addWidget(mIsAutoSave, 3, 0);
+    //gridLayout->addWidget(labelAutoSave, 4, 0);
+    gridLayout->addWidget(mAutoSaveInterval, 3, 1);
 
     QGroupBox* groupBox = new QGroupBox(tr("Image Settings"));
     groupBox->setLayout(gridLayout);
@@ -283,6 +291,39 @@ QGroupBox* SettingsDialog::createScriptSettings()
     venvLayout->addWidget(mVenvPathInput);
     venvLayout->addWidget(chooseVenvBtn);
 
+    QLabel* previewFpsLabel = new QLabel(tr("Preview frame rate limit (FPS):"));
+    mPreviewMaxFps = new QSpinBox();
+    mPreviewMaxFps->setRange(1, 60);
+    mPreviewMaxFps->setValue(DataSingleton::Instance()->getPreviewMaxFps());
+    mPreviewMaxFps->setFixedWidth(80);
+
+    QHBoxLayout* previewLayout = new QHBoxLayout;
+    previewLayout->addWidget(previewFpsLabel);
+    previewLayout->addWidget(mPreviewMaxFps);
+    previewLayout->addStretch();
+
+    QLabel* workerCountLabel = new QLabel(tr("Worker processes (0 - run in editor):"));
+    mScriptWorkerCount = new QSpinBox();
+    mScriptWorkerCount->setRange(0, 16);
+    mScriptWorkerCount->setValue(DataSingleton::Instance()->getScriptWorkerCount());
+    mScriptWorkerCount->setFixedWidth(80);
+
+    QHBoxLayout* workerLayout = new QHBoxLayout;
+    workerLayout->addWidget(workerCountLabel);
+    workerLayout->addWidget(mScriptWorkerCount);
+    workerLayout->addStretch();
+
+    QLabel* idleUnloadLabel = new QLabel(tr("Unload script models after idle minutes (0 - never):"));
+    mScriptIdleUnload = new QSpinBox();
+    mScriptIdleUnload->setRange(0, 24 * 60);
+    mScriptIdleUnload->setValue(DataSingleton::Instance()->getScriptIdleUnload());
+    mScriptIdleUnload->setFixedWidth(80);
+
+    QHBoxLayout* idleUnloadLayout = new QHBoxLayout;
+    idleUnloadLayout->addWidget(idleUnloadLabel);
+    idleUnloadLayout->addWidget(mScriptIdleUnload);
+    idleUnloadLayout->addStretch();
+
     // Combine Everything
 
     QVBoxLayout* vLayout = new QVBoxLayout;
@@ -291,6 +332,9 @@ QGroupBox* SettingsDialog::createScriptSettings()
     vLayout->addSpacing(10);               // small gap
     //vLayout->addWidget(mUseVenvCheckbox);
     vLayout->addLayout(venvLayout);
+    vLayout->addLayout(previewLayout);
+    vLayout->addLayout(workerLayout);
+    vLayout->addLayout(idleUnloadLayout);
 
     QGroupBox* groupBox = new QGroupBox(tr("Python Script and Virtual-Env Settings"));
     groupBox->setLayout(vLayout);
@@ -349,6 +393,7 @@ void SettingsDialog::sendSettingsToSingleton()
 {
     DataSingleton::Instance()->setBaseSize(QSize(mWidth->value(), mHeight->value()));
     DataSingleton::Instance()->setHistoryDepth(mHistoryDepth->value());
+    DataSingleton::Instance()->setHistoryMemoryLimit(mHistoryMemoryLimit->value());
     DataSingleton::Instance()->setIsAutoSave(mIsAutoSave->isChecked());
     DataSingleton::Instance()->setIsRestoreWindowSize(mIsRestoreWindowSize->isChecked());
     DataSingleton::Instance()->setIsAskCanvasSize(mIsAskCanvasSize->isChecked());
@@ -357,6 +402,9 @@ void SettingsDialog::sendSettingsToSingleton()
     DataSingleton::Instance()->setIsLoadScript(mLoadScriptCheckbox->isChecked());
     DataSingleton::Instance()->setScriptPath(mScriptPathInput->text());
     DataSingleton::Instance()->setVirtualEnvPath(mVenvPathInput->text());
+    DataSingleton::Instance()->setPreviewMaxFps(mPreviewMaxFps->value());
+    DataSingleton::Instance()->setScriptWorkerCount(mScriptWorkerCount->value());
+    DataSingleton::Instance()->setScriptIdleUnload(mScriptIdleUnload->value());
 
     QStringList languages;
     languages << "system" << "easypaint_en_EN" << "easypaint_cs_CZ" << "easypaint_fr_FR" << "easypaint_ru_RU" << "easypaint_zh_CN";
@@ -78,7 +78,7 @@ private:
     void createItemsGroup(const QString &name, const QMap<QString, QKeySequence> &shortcuts);
 
     QComboBox *mLanguageBox;
-    QSpinBox *mWidth, *mHeight, *mHistoryDepth, *mAutoSaveInterval;
+    QSpinBox *mWidth, *mHeight, *mHistoryDepth, *mHistoryMemoryLimit, *mAutoSaveInterval;
     QCheckBox *mIsAutoSave;
     QCheckBox *mIsRestoreWindowSize;
     ShortcutEdit *mShortcutEdit;
@@ -90,6 +90,9 @@ private:
     QCheckBox* mLoadScriptCheckbox;
     QLineEdit* mScriptPathInput;
     QLineEdit* mVenvPathInput;
+    QSpinBox* mPreviewMaxFps;
+    QSpinBox* mScriptWorkerCount;
+    QSpinBox* mScriptIdleUnload;
     
     bool mStartAppOnStartingOS;
 
@@ -0,0 +1,160 @@
+#include "displaypyramid.h"
+
+namespace {
+
+QSize levelSize(const QSize &sourceSize, int level)
+{
+    const int round = (1 << level) - 1;
+    return QSize((sourceSize.width() + round) >> level, (sourceSize.height() + round) >> level);
+}
+
+QRect toLevel(const QRect &rect, int level)
+{
+    return QRect(QPoint(rect.left() >> level, rect.top() >> level),
+                 QPoint(rect.right() >> level, rect.bottom() >> level));
+}
+
+bool isDirectFormat(const QImage &image)
+{
+    return image.format() == QImage::Format_ARGB32_Premultiplied
+        || image.format() == QImage::Format_RGB32;
+}
+
+inline QRgb average(QRgb a, QRgb b, QRgb c, QRgb d)
+{
+    // Two channels at a time, sum of four bytes fits into 16 bit lane
+    const quint32 rb = (a & 0x00ff00ff) + (b & 0x00ff00ff) + (c & 0x00ff00ff) + (d & 0x00ff00ff)
+                     + 0x00020002;
+    const quint32 ag = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff)
+                     + ((c >> 8) & 0x00ff00ff) + ((d >> 8) & 0x00ff00ff) + 0x00020002;
+    return ((rb >> 2) & 0x00ff00ff) | (((ag >> 2) & 0x00ff00ff) << 8);
+}
+
+/**
+ * @brief Box filter 2x2 pixels of src into dstRect of dst.
+ *
+ * @param srcOrigin Position of src top left pixel in coordinates of the level above dst.
+ */
+void halve(const QImage &src, const QPoint &srcOrigin, QImage &dst, const QRect &dstRect)
+{
+    const int lastX = src.width() - 1;
+    const int lastY = src.height() - 1;
+    for (int y = dstRect.top(); y <= dstRect.bottom(); ++y)
+    {
+        const int sy0 = 2 * y - srcOrigin.y();
+        const int sy1 = qMin(sy0 + 1, lastY);
+        const QRgb *row0 = reinterpret_cast<const QRgb*>(src.constScanLine(sy0));
+        const QRgb *row1 = reinterpret_cast<const QRgb*>(src.constScanLine(sy1));
+        QRgb *out = reinterpret_cast<QRgb*>(dst.scanLine(y));
+        for (int x = dstRect.left(); x <= dstRect.right(); ++x)
+        {
+            const int sx0 = 2 * x - srcOrigin.x();
+            const int sx1 = qMin(sx0 + 1, lastX);
+            out[x] = average(row0[sx0], row0[sx1], row1[sx0], row1[sx1]);
+        }
+    }
+}
+
+}
+
+int DisplayPyramid::levelForZoom(qreal zoomFactor)
+{
+    int level = 0;
+    while (level < LEVELS_COUNT && zoomFactor <= 1.0 / (2 << level))
+        ++level;
+    return level;
+}
+
+void DisplayPyramid::invalidate(const QRect &rect)
+{
+    const QRect sourceRect = rect.normalized().intersected(QRect(QPoint(0, 0), mSourceSize));
+    if (sourceRect.isEmpty())
+        return;
+
+    for (int level = 1; level <= LEVELS_COUNT; ++level)
+    {
+        Level &current = mLevels[level - 1];
+        if (current.image.isNull())
+            continue;
+        const QRect levelRect = toLevel(sourceRect, level);
+        for (int ty = levelRect.top() / TILE_SIZE; ty <= levelRect.bottom() / TILE_SIZE; ++ty)
+        {
+            for (int tx = levelRect.left() / TILE_SIZE; tx <= levelRect.right() / TILE_SIZE; ++tx)
+                current.dirtyTiles[ty * current.tilesPerRow + tx] = true;
+        }
+    }
+}
+
+void DisplayPyramid::clear()
+{
+    for (Level &level : mLevels)
+        level = Level();
+    mSourceSize = QSize();
+}
+
+const QImage& DisplayPyramid::getLevel(const QImage &source, int level, const QRect &rect)
+{
+    if (source.size() != mSourceSize)
+    {
+        clear();
+        mSourceSize = source.size();
+    }
+    level = qBound(1, level, int(LEVELS_COUNT));
+    const QRect sourceRect = rect.intersected(source.rect());
+    if (!sourceRect.isEmpty())
+        build(source, level, toLevel(sourceRect, level));
+    return ensureLevel(level).image;
+}
+
+DisplayPyramid::Level& DisplayPyramid::ensureLevel(int level)
+{
+    Level &current = mLevels[level - 1];
+    if (current.image.isNull())
+    {
+        const QSize size = levelSize(mSourceSize, level);
+        current.image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        current.tilesPerRow = (size.width() + TILE_SIZE - 1) / TILE_SIZE;
+        const int rows = (size.height() + TILE_SIZE - 1) / TILE_SIZE;
+        current.dirtyTiles.fill(true, current.tilesPerRow * rows);
+    }
+    return current;
+}
+
+void DisplayPyramid::build(const QImage &source, int level, const QRect &levelRect)
+{
+    Level &current = ensureLevel(level);
+    const QRect area = levelRect.intersected(current.image.rect());
+    if (area.isEmpty())
+        return;
+
+    const QRect previousRect(QPoint(0, 0), level == 1 ? mSourceSize : levelSize(mSourceSize, level - 1));
+    for (int ty = area.top() / TILE_SIZE; ty <= area.bottom() / TILE_SIZE; ++ty)
+    {
+        for (int tx = area.left() / TILE_SIZE; tx <= area.right() / TILE_SIZE; ++tx)
+        {
+            const int index = ty * current.tilesPerRow + tx;
+            if (!current.dirtyTiles[index])
+                continue;
+
+            const QRect tileRect = QRect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE)
+                                       .intersected(current.image.rect());
+            const QRect previousTileRect = QRect(tileRect.topLeft() * 2, tileRect.size() * 2)
+                                               .intersected(previousRect);
+            if (level > 1)
+            {
+                build(source, level - 1, previousTileRect);
+                halve(mLevels[level - 2].image, QPoint(0, 0), current.image, tileRect);
+            }
+            else if (isDirectFormat(source))
+            {
+                halve(source, QPoint(0, 0), current.image, tileRect);
+            }
+            else
+            {
+                halve(source.copy(previousTileRect).convertToFormat(QImage::Format_ARGB32_Premultiplied),
+                      previousTileRect.topLeft(), current.image, tileRect);
+            }
+            current.dirtyTiles[index] = false;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QVector>
+
+/**
+ * @brief Downscaled copies of an image (1/2, 1/4, 1/8) used to draw it zoomed out.
+ *
+ * Levels are built lazily, tile by tile and only for the area which is about to
+ * be drawn, so the cost of painting depends on the viewport rather than on the
+ * image size. Edited areas are marked dirty and rebuilt on the next request.
+ */
+class DisplayPyramid
+{
+public:
+    enum { LEVELS_COUNT = 3, TILE_SIZE = 128 };
+
+    /**
+     * @brief Level to draw the image from at given zoom, 0 means the image itself.
+     */
+    static int levelForZoom(qreal zoomFactor);
+
+    /**
+     * @brief Mark area of the source image as changed.
+     *
+     * @param rect Area in source image coordinates.
+     */
+    void invalidate(const QRect &rect);
+    /**
+     * @brief Drop all levels, e.g. when the source image was replaced.
+     */
+    void clear();
+
+    /**
+     * @brief Get level with the requested area up to date.
+     *
+     * @param source Image the pyramid is built for.
+     * @param level Level number, 1 is half of the source size.
+     * @param rect Area in source image coordinates which is going to be drawn.
+     */
+    const QImage& getLevel(const QImage &source, int level, const QRect &rect);
+
+private:
+    struct Level
+    {
+        QImage image;
+        QVector<bool> dirtyTiles;
+        int tilesPerRow = 0;
+    };
+
+    /**
+     * @brief Rebuild dirty tiles of level intersecting the area given in level coordinates.
+     */
+    void build(const QImage &source, int level, const QRect &levelRect);
+    /**
+     * @brief Allocate level image and mark all of its tiles dirty.
+     */
+    Level& ensureLevel(int level);
+
+    Level mLevels[LEVELS_COUNT];
+    QSize mSourceSize;
+};
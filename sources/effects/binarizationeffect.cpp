@@ -25,6 +25,7 @@
 
 #include "binarizationeffect.h"
 #include "../imagearea.h"
+#include "pointops.h"
 
 BinarizationEffect::BinarizationEffect(QObject *parent) :
     AbstractEffect(parent)
@@ -39,27 +40,13 @@ ImageArea* BinarizationEffect::applyEffect(ImageArea* imageArea)
     makeBinarization(*imageArea, 200, 100);
 
     imageArea->setEdited(true);
-    imageArea->update();
+    imageArea->updateImageRect(imageArea->getImage()->rect());
 
     return imageArea;
 }
 
 void BinarizationEffect::makeBinarization(ImageArea &imageArea, int coeff1, int coeff2)
 {
-    for (int x(0); x < imageArea.getImage()->width(); x++)
-    {
-        for (int y(0); y < imageArea.getImage()->height(); y++)
-        {
-            QRgb pixel = imageArea.getImage()->pixel(x, y);
-            int r = (int)qRed(pixel);
-            if (r >= coeff1)
-                r = 0;
-            else if (r >= coeff2 && r < coeff1)
-                    r = 255;
-            else
-                r = 0;
-            pixel = qRgb(r, r, r);
-            imageArea.getImage()->setPixel(x, y, pixel);
-        }
-    }
+    // White where coeff2 <= red < coeff1, black elsewhere
+    PointOps::bandThreshold(*imageArea.getImage(), coeff2, coeff1);
 }
@@ -0,0 +1,336 @@
+#include "convolution.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const int BAND_HEIGHT = 32;
+const int MIN_FIXED_POINT_BITS = 6;
+const double SEPARABLE_EPSILON = 1e-9;
+
+int borderIndex(int i, int size, BorderMode border)
+{
+    if (i >= 0 && i < size)
+        return i;
+    if (border == BorderMode::Reflect && size > 1)
+    {
+        const int period = 2 * (size - 1);
+        i = std::abs(i) % period;
+        return i < size ? i : period - i;
+    }
+    return qBound(0, i, size - 1);
+}
+
+QVector<int> borderTable(int size, int radius, BorderMode border)
+{
+    QVector<int> table(size + 2 * radius);
+    for (int i = 0; i < table.size(); ++i)
+        table[i] = borderIndex(i - radius, size, border);
+    return table;
+}
+
+/**
+ * @brief Scale bits for weights, such that accumulated sums stay below 2^30.
+ */
+int fixedPointBits(const QVector<double> &weights, double inputMax)
+{
+    double sumAbs = 0;
+    for (double weight : weights)
+        sumAbs += std::abs(weight);
+    int bits = 14;
+    while (bits > 0 && inputMax * sumAbs * (1 << bits) >= double(1 << 30))
+        --bits;
+    return bits;
+}
+
+QVector<int> toFixedPoint(const QVector<double> &weights, int bits)
+{
+    QVector<int> result(weights.size());
+    for (int i = 0; i < weights.size(); ++i)
+        result[i] = int(std::lround(weights[i] * (1 << bits)));
+    return result;
+}
+
+inline quint32 opaquePixel(int r, int g, int b)
+{
+    return 0xff000000u | (quint32(qBound(0, r, 255)) << 16) | (quint32(qBound(0, g, 255)) << 8)
+        | quint32(qBound(0, b, 255));
+}
+
+/**
+ * @brief Run band over all rows, false if it was interrupted and some rows were skipped.
+ */
+template<typename Band>
+bool forEachBand(int height, const std::function<bool()> &isInterrupted, Band band)
+{
+    QVector<int> tops;
+    for (int top = 0; top < height; top += BAND_HEIGHT)
+        tops.append(top);
+    std::atomic<bool> isSkipped(false);
+    QtConcurrent::blockingMap(tops, [&](int top) {
+        if (isInterrupted && isInterrupted())
+        {
+            isSkipped = true;
+            return;
+        }
+        band(top, qMin(top + BAND_HEIGHT, height));
+    });
+    return !isSkipped;
+}
+
+struct Context
+{
+    const QImage &source;
+    uchar *resultBits; /**< Taken before threads start, scanLine() would detach concurrently. */
+    qsizetype resultBytesPerLine;
+    BorderMode border;
+    int radius;
+    QVector<int> xTable; /**< Source column for padded column index. */
+};
+
+const quint32 *sourceRow(const Context &context, int y)
+{
+    return reinterpret_cast<const quint32*>(context.source.constScanLine(
+        borderIndex(y, context.source.height(), context.border)));
+}
+
+quint32 *resultRow(const Context &context, int y)
+{
+    return reinterpret_cast<quint32*>(context.resultBits + y * context.resultBytesPerLine);
+}
+
+void convolve2DFixed(const Context &context, const QVector<int> &weights, int bits, int top, int bottom)
+{
+    const int size = 2 * context.radius + 1;
+    const int width = context.source.width();
+    const int half = 1 << (bits - 1);
+    std::vector<const quint32*> rows(size);
+    for (int y = top; y < bottom; ++y)
+    {
+        for (int k = 0; k < size; ++k)
+            rows[k] = sourceRow(context, y + k - context.radius);
+        quint32 *out = resultRow(context, y);
+        for (int x = 0; x < width; ++x)
+        {
+            int r = half, g = half, b = half;
+            const int *weight = weights.constData();
+            for (int ky = 0; ky < size; ++ky)
+            {
+                const quint32 *row = rows[ky];
+                const int *columns = context.xTable.constData() + x;
+                for (int kx = 0; kx < size; ++kx, ++weight)
+                {
+                    const quint32 pixel = row[columns[kx]];
+                    r += *weight * int((pixel >> 16) & 0xff);
+                    g += *weight * int((pixel >> 8) & 0xff);
+                    b += *weight * int(pixel & 0xff);
+                }
+            }
+            out[x] = opaquePixel(r >> bits, g >> bits, b >> bits);
+        }
+    }
+}
+
+void convolve2DFloat(const Context &context, const QVector<double> &weights, int top, int bottom)
+{
+    const int size = 2 * context.radius + 1;
+    const int width = context.source.width();
+    std::vector<const quint32*> rows(size);
+    for (int y = top; y < bottom; ++y)
+    {
+        for (int k = 0; k < size; ++k)
+            rows[k] = sourceRow(context, y + k - context.radius);
+        quint32 *out = resultRow(context, y);
+        for (int x = 0; x < width; ++x)
+        {
+            double r = 0, g = 0, b = 0;
+            const double *weight = weights.constData();
+            for (int ky = 0; ky < size; ++ky)
+            {
+                const quint32 *row = rows[ky];
+                const int *columns = context.xTable.constData() + x;
+                for (int kx = 0; kx < size; ++kx, ++weight)
+                {
+                    const quint32 pixel = row[columns[kx]];
+                    r += *weight * ((pixel >> 16) & 0xff);
+                    g += *weight * ((pixel >> 8) & 0xff);
+                    b += *weight * (pixel & 0xff);
+                }
+            }
+            out[x] = opaquePixel(qRound(r), qRound(g), qRound(b));
+        }
+    }
+}
+
+/**
+ * @brief Horizontal pass into band buffer (with radius rows above and below), then vertical pass.
+ */
+void convolveSeparableFixed(const Context &context, const QVector<int> &column, int columnBits,
+                            const QVector<int> &row, int rowBits, int top, int bottom)
+{
+    const int size = 2 * context.radius + 1;
+    const int width = context.source.width();
+    const int bufferRows = bottom - top + 2 * context.radius;
+
+    // Three channels per pixel, horizontal sums are kept unshifted to not lose precision
+    std::vector<qint32> buffer(size_t(bufferRows) * width * 3);
+    for (int by = 0; by < bufferRows; ++by)
+    {
+        const quint32 *src = sourceRow(context, top + by - context.radius);
+        qint32 *dst = buffer.data() + size_t(by) * width * 3;
+        for (int x = 0; x < width; ++x, dst += 3)
+        {
+            qint32 r = 0, g = 0, b = 0;
+            const int *columns = context.xTable.constData() + x;
+            for (int k = 0; k < size; ++k)
+            {
+                const quint32 pixel = src[columns[k]];
+                r += row[k] * int((pixel >> 16) & 0xff);
+                g += row[k] * int((pixel >> 8) & 0xff);
+                b += row[k] * int(pixel & 0xff);
+            }
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+        }
+    }
+
+    const int bits = rowBits + columnBits;
+    const qint64 half = qint64(1) << (bits - 1);
+    for (int y = top; y < bottom; ++y)
+    {
+        quint32 *out = resultRow(context, y);
+        const qint32 *first = buffer.data() + size_t(y - top) * width * 3;
+        for (int x = 0; x < width; ++x)
+        {
+            qint64 r = half, g = half, b = half;
+            const qint32 *src = first + x * 3;
+            for (int k = 0; k < size; ++k, src += size_t(width) * 3)
+            {
+                r += qint64(column[k]) * src[0];
+                g += qint64(column[k]) * src[1];
+                b += qint64(column[k]) * src[2];
+            }
+            out[x] = opaquePixel(int(r >> bits), int(g >> bits), int(b >> bits));
+        }
+    }
+}
+
+} // namespace
+
+ConvolutionKernel::ConvolutionKernel(int size, const QVector<double> &weights)
+{
+    if (size <= 0 || size % 2 == 0 || weights.size() != size * size)
+        return;
+    double total = 0;
+    for (double weight : weights)
+        total += weight;
+    mSize = size;
+    mWeights = weights;
+    if (total != 0)
+    {
+        for (double &weight : mWeights)
+            weight /= total;
+    }
+}
+
+ConvolutionKernel ConvolutionKernel::fromSettings(const QVariantList &matrix)
+{
+    const int size = int(std::lround(std::sqrt(double(matrix.size()))));
+    QVector<double> weights;
+    weights.reserve(matrix.size());
+    for (const QVariant &value : matrix)
+        weights.append(value.toDouble());
+    return ConvolutionKernel(size, weights);
+}
+
+bool ConvolutionKernel::separate(QVector<double> &column, QVector<double> &row) const
+{
+    if (!isValid())
+        return false;
+
+    // Largest weight is the most stable pivot for the outer product
+    int pivot = 0;
+    for (int i = 1; i < mWeights.size(); ++i)
+    {
+        if (std::abs(mWeights[i]) > std::abs(mWeights[pivot]))
+            pivot = i;
+    }
+    const double pivotValue = mWeights[pivot];
+    if (pivotValue == 0)
+        return false;
+    const int pivotRow = pivot / mSize;
+    const int pivotColumn = pivot % mSize;
+
+    column.resize(mSize);
+    row.resize(mSize);
+    for (int i = 0; i < mSize; ++i)
+    {
+        column[i] = mWeights[i * mSize + pivotColumn];
+        row[i] = mWeights[pivotRow * mSize + i] / pivotValue;
+    }
+
+    const double tolerance = SEPARABLE_EPSILON * std::abs(pivotValue);
+    for (int y = 0; y < mSize; ++y)
+    {
+        for (int x = 0; x < mSize; ++x)
+        {
+            if (std::abs(column[y] * row[x] - mWeights[y * mSize + x]) > tolerance)
+                return false;
+        }
+    }
+    return true;
+}
+
+QImage convolve(const QImage &source, const ConvolutionKernel &kernel, BorderMode border,
+                const std::function<bool()> &isInterrupted)
+{
+    if (source.isNull() || !kernel.isValid())
+        return source;
+
+    // Straight alpha, as QImage::pixel() gave before
+    const QImage input = source.convertToFormat(QImage::Format_ARGB32);
+    QImage result(input.size(), QImage::Format_ARGB32_Premultiplied);
+    Context context = { input, result.bits(), result.bytesPerLine(), border, kernel.radius(),
+                        borderTable(input.width(), kernel.radius(), border) };
+
+    QVector<double> column, row;
+    if (kernel.separate(column, row))
+    {
+        // Horizontal sums fit 32 bits, vertical pass accumulates them in 64 bits
+        const int rowBits = fixedPointBits(row, 255);
+        const int columnBits = fixedPointBits(column, 1);
+        if (rowBits >= MIN_FIXED_POINT_BITS && columnBits >= MIN_FIXED_POINT_BITS)
+        {
+            const QVector<int> rowWeights = toFixedPoint(row, rowBits);
+            const QVector<int> columnWeights = toFixedPoint(column, columnBits);
+            const bool isComplete = forEachBand(input.height(), isInterrupted, [&](int top, int bottom) {
+                convolveSeparableFixed(context, columnWeights, columnBits, rowWeights, rowBits, top, bottom);
+            });
+            return isComplete ? result : QImage();
+        }
+    }
+
+    const int bits = fixedPointBits(kernel.weights(), 255);
+    bool isComplete;
+    if (bits >= MIN_FIXED_POINT_BITS)
+    {
+        const QVector<int> weights = toFixedPoint(kernel.weights(), bits);
+        isComplete = forEachBand(input.height(), isInterrupted, [&](int top, int bottom) {
+            convolve2DFixed(context, weights, bits, top, bottom);
+        });
+    }
+    else
+    {
+        isComplete = forEachBand(input.height(), isInterrupted, [&](int top, int bottom) {
+            convolve2DFloat(context, kernel.weights(), top, bottom);
+        });
+    }
+    // Skipped bands were never written
+    return isComplete ? result : QImage();
+}
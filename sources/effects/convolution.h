@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QImage>
+#include <QVariantList>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Square convolution kernel, parsed and normalized once.
+ */
+class ConvolutionKernel
+{
+public:
+    ConvolutionKernel() = default;
+    /**
+     * @brief Kernel of size x size weights in row-major order, divided by their sum unless it is zero.
+     */
+    ConvolutionKernel(int size, const QVector<double> &weights);
+
+    /**
+     * @brief Kernel from effect settings, list of size^2 numbers with odd size.
+     */
+    static ConvolutionKernel fromSettings(const QVariantList &matrix);
+
+    bool isValid() const { return mSize > 0; }
+    int size() const { return mSize; }
+    int radius() const { return mSize / 2; }
+    const QVector<double> &weights() const { return mWeights; }
+
+    /**
+     * @brief Split kernel into column and row factors if it is their outer product (rank 1).
+     */
+    bool separate(QVector<double> &column, QVector<double> &row) const;
+
+private:
+    int mSize = 0;
+    QVector<double> mWeights;
+};
+
+enum class BorderMode
+{
+    Clamp, /**< Repeat edge pixels. */
+    Reflect /**< Mirror image at the edge, without repeating edge pixels. */
+};
+
+/**
+ * @brief Convolve red, green and blue channels of the image, result is opaque.
+ *
+ * Separable kernels run as two 1D passes. 8-bit data is processed in fixed
+ * point unless weights are too large for it. Row bands are spread over the
+ * global thread pool; isInterrupted is polled between bands from worker threads.
+ * Null image is returned if it stopped the work before all bands were done.
+ */
+QImage convolve(const QImage &source, const ConvolutionKernel &kernel,
+                BorderMode border = BorderMode::Clamp,
+                const std::function<bool()> &isInterrupted = {});
@@ -0,0 +1,39 @@
+#include "effectruncallback.h"
+
+EffectRunCallback::EffectRunCallback(int maxFps) :
+    mMaxFps(maxFps), mMinInterval(maxFps > 0 ? 1000 / maxFps : 0)
+{
+}
+
+bool EffectRunCallback::isPreviewWanted()
+{
+    if (mIsInterrupted)
+        return false;
+    QMutexLocker locker(&mMutex);
+    if (mHasImage)
+        return false;
+    return !mPostTimer.isValid() || mPostTimer.elapsed() >= mMinInterval;
+}
+
+void EffectRunCallback::postImage(const QImage& img)
+{
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&mMutex);
+        mImage = img;
+        wasEmpty = !mHasImage;
+        mHasImage = true;
+        mPostTimer.start();
+    }
+    if (wasEmpty)
+        emit imageReady();
+}
+
+QImage EffectRunCallback::takeImage()
+{
+    QMutexLocker locker(&mMutex);
+    mHasImage = false;
+    QImage result = mImage;
+    mImage = QImage();
+    return result;
+}
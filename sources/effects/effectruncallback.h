@@ -1,18 +1,58 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QImage>
 
+/**
+ * @brief Link between running effect and its caller: interruption and preview frames.
+ *
+ * Preview frames go through a single slot mailbox. The worker posts the latest
+ * frame, replacing one not taken yet, and the receiver is notified once per
+ * filled mailbox. Producers ask isPreviewWanted() first to skip building frames
+ * nobody would see.
+ */
 class EffectRunCallback : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @param maxFps Limit of preview frames per second, 0 for no limit.
+     */
+    explicit EffectRunCallback(int maxFps = 0);
+
     bool isInterrupted() { return mIsInterrupted;  }
+    int getMaxFps() const { return mMaxFps; }
     void interrupt() { mIsInterrupted = true; }
 
+    /**
+     * @brief Whether the previous frame was taken and frame interval has passed.
+     */
+    bool isPreviewWanted();
+    /**
+     * @brief Put frame into the mailbox, may be called from any thread.
+     */
+    void postImage(const QImage& img);
+    /**
+     * @brief Take the latest frame out of the mailbox, null if it is empty.
+     */
+    QImage takeImage();
+
 signals:
-    void sendImage(const QImage& img);
+    /**
+     * @brief Mailbox got a frame, emitted from the posting thread.
+     */
+    void imageReady();
 
 private:
     std::atomic_bool mIsInterrupted = false;
+
+    QMutex mMutex;
+    QImage mImage;
+    bool mHasImage = false;
+    QElapsedTimer mPostTimer; /**< Time since the last posted frame. */
+    int mMaxFps;
+    qint64 mMinInterval; /**< Milliseconds between frames. */
 };
@@ -49,6 +49,15 @@ public:
     virtual AbstractEffectSettings* getSettingsWidget() = 0;
 
     virtual void convertImage(const QImage* source, const QImage* markup, QImage& image, const QVariantList& matrix, std::weak_ptr<EffectRunCallback> callback = {}) = 0;
+    /**
+     * @brief Whether a run on a downscaled copy gives a faithful preview.
+     *
+     * Then settings dialog shows the effect on a proxy of preview size first,
+     * full resolution result follows in background. Effects with sizes measured
+     * in pixels, such as convolution kernels, look stronger on the proxy and
+     * must not opt in.
+     */
+    virtual bool isProxyPreviewSupported() const { return false; }
 };
 
 #endif // CONVOLUTIONMATRIXEFFECT_H
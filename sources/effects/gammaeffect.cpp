@@ -25,8 +25,7 @@
 
 #include "gammaeffect.h"
 #include "../imagearea.h"
-
-#include <math.h>
+#include "pointops.h"
 
 GammaEffect::GammaEffect(QObject *parent) :
     AbstractEffect(parent)
@@ -41,26 +40,12 @@ ImageArea* GammaEffect::applyEffect(ImageArea* imageArea)
     makeGamma(*imageArea, 2);
 
     imageArea->setEdited(true);
-    imageArea->update();
+    imageArea->updateImageRect(imageArea->getImage()->rect());
 
     return imageArea;
 }
 
 void GammaEffect::makeGamma(ImageArea &imageArea, float modificator)
 {
-    for(int x(0); x < imageArea.getImage()->width(); x++)
-    {
-        for(int y(0); y < imageArea.getImage()->height(); y++)
-        {
-            QRgb pixel = imageArea.getImage()->pixel(x, y);
-            float r = qRed(pixel);
-            r = 255 * pow(r / 255, modificator);
-            float g = qGreen(pixel);
-            g = 255 * pow(g / 255, modificator);
-            float b = qBlue(pixel);
-            b = 255 * pow(b / 255, modificator);
-            pixel = qRgb(r, g, b);
-            imageArea.getImage()->setPixel(x, y, pixel);
-        }
-    }
+    PointOps::applyLut(*imageArea.getImage(), PointOps::gammaLut(modificator));
 }
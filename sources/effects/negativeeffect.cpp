@@ -38,7 +38,7 @@ ImageArea* NegativeEffect::applyEffect(ImageArea* imageArea)
 
     imageArea->getImage()->invertPixels(QImage::InvertRgb);
     imageArea->setEdited(true);
-    imageArea->update();
+    imageArea->updateImageRect(imageArea->getImage()->rect());
 
     return imageArea;
 }
@@ -0,0 +1,227 @@
+#include "pointops.h"
+#include "pointops_p.h"
+#include "../cpufeatures.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QVector>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EASYPAINT_SSE2
+#endif
+
+using namespace PointOps::Detail;
+
+namespace {
+
+const int BAND_HEIGHT = 64;
+const qint64 MIN_PARALLEL_PIXELS = 512 * 512;
+
+inline QRgb straight(quint32 pixel, bool isPremultiplied)
+{
+    return isPremultiplied ? qUnpremultiply(pixel) : pixel;
+}
+
+inline quint32 grayPixel(quint32 pixel, bool isPremultiplied)
+{
+    const QRgb rgb = straight(pixel, isPremultiplied);
+    const quint32 gray = (qRed(rgb) * WEIGHT_R + qGreen(rgb) * WEIGHT_G + qBlue(rgb) * WEIGHT_B) >> 15;
+    return 0xff000000u | (gray << 16) | (gray << 8) | gray;
+}
+
+inline quint32 thresholdPixel(quint32 pixel, int low, int high, bool isPremultiplied)
+{
+    const int red = qRed(straight(pixel, isPremultiplied));
+    return (red >= low && red < high) ? 0xffffffffu : 0xff000000u;
+}
+
+bool prepare(QImage &image)
+{
+    if (image.isNull())
+        return false;
+    switch (image.format())
+    {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        break;
+    default:
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        break;
+    }
+    return true;
+}
+
+/**
+ * @brief Call rowFunction(row, width) for every row, in bands on the global thread pool.
+ */
+template<typename RowFunction>
+void forEachRow(QImage &image, RowFunction rowFunction)
+{
+    uchar *bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+    const int width = image.width();
+    const int height = image.height();
+
+    auto processBand = [=](int top) {
+        const int bottom = qMin(top + BAND_HEIGHT, height);
+        for (int y = top; y < bottom; ++y)
+            rowFunction(reinterpret_cast<quint32*>(bits + y * bytesPerLine), width);
+    };
+
+    if (qint64(width) * height < MIN_PARALLEL_PIXELS)
+    {
+        for (int top = 0; top < height; top += BAND_HEIGHT)
+            processBand(top);
+        return;
+    }
+
+    QVector<int> bands;
+    for (int top = 0; top < height; top += BAND_HEIGHT)
+        bands.append(top);
+    QtConcurrent::blockingMap(bands, processBand);
+}
+
+} // namespace
+
+void PointOps::Detail::grayscaleRowScalar(quint32 *row, int count, bool isPremultiplied)
+{
+    for (int i = 0; i < count; ++i)
+        row[i] = grayPixel(row[i], isPremultiplied);
+}
+
+void PointOps::Detail::thresholdRowScalar(quint32 *row, int count, int low, int high, bool isPremultiplied)
+{
+    for (int i = 0; i < count; ++i)
+        row[i] = thresholdPixel(row[i], low, high, isPremultiplied);
+}
+
+#ifdef EASYPAINT_SSE2
+
+namespace {
+
+inline bool isOpaque(__m128i pixels)
+{
+    const __m128i alphaMask = _mm_set1_epi32(int(0xff000000));
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, alphaMask), alphaMask)) == 0xffff;
+}
+
+} // namespace
+
+void PointOps::Detail::grayscaleRowSse2(quint32 *row, int count, bool isPremultiplied)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_set_epi16(0, WEIGHT_R, WEIGHT_G, WEIGHT_B, 0, WEIGHT_R, WEIGHT_G, WEIGHT_B);
+    const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i *ptr = reinterpret_cast<__m128i*>(row + i);
+        const __m128i pixels = _mm_loadu_si128(ptr);
+        if (!isOpaque(pixels))
+        {
+            grayscaleRowScalar(row + i, 4, isPremultiplied);
+            continue;
+        }
+        // B*wb + G*wg and R*wr + A*0 for each pixel, then sum the halves
+        const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+        const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+        const __m128 loF = _mm_castsi128_ps(lo);
+        const __m128 hiF = _mm_castsi128_ps(hi);
+        const __m128i even = _mm_castps_si128(_mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m128i gray = _mm_srli_epi32(_mm_add_epi32(even, odd), 15);
+        const __m128i result = _mm_or_si128(_mm_or_si128(gray, _mm_slli_epi32(gray, 8)),
+                                            _mm_or_si128(_mm_slli_epi32(gray, 16), alpha));
+        _mm_storeu_si128(ptr, result);
+    }
+    grayscaleRowScalar(row + i, count - i, isPremultiplied);
+}
+
+void PointOps::Detail::thresholdRowSse2(quint32 *row, int count, int low, int high, bool isPremultiplied)
+{
+    const __m128i lowBound = _mm_set1_epi32(low - 1);
+    const __m128i highBound = _mm_set1_epi32(high);
+    const __m128i channelMask = _mm_set1_epi32(0xff);
+    const __m128i colorMask = _mm_set1_epi32(0x00ffffff);
+    const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i *ptr = reinterpret_cast<__m128i*>(row + i);
+        const __m128i pixels = _mm_loadu_si128(ptr);
+        if (!isOpaque(pixels))
+        {
+            thresholdRowScalar(row + i, 4, low, high, isPremultiplied);
+            continue;
+        }
+        const __m128i red = _mm_and_si128(_mm_srli_epi32(pixels, 16), channelMask);
+        const __m128i inside = _mm_and_si128(_mm_cmpgt_epi32(red, lowBound), _mm_cmplt_epi32(red, highBound));
+        _mm_storeu_si128(ptr, _mm_or_si128(_mm_and_si128(inside, colorMask), alpha));
+    }
+    thresholdRowScalar(row + i, count - i, low, high, isPremultiplied);
+}
+
+#else
+
+void PointOps::Detail::grayscaleRowSse2(quint32 *row, int count, bool isPremultiplied)
+{
+    grayscaleRowScalar(row, count, isPremultiplied);
+}
+
+void PointOps::Detail::thresholdRowSse2(quint32 *row, int count, int low, int high, bool isPremultiplied)
+{
+    thresholdRowScalar(row, count, low, high, isPremultiplied);
+}
+
+#endif // EASYPAINT_SSE2
+
+PointOps::Lut PointOps::gammaLut(float gamma)
+{
+    Lut lut;
+    for (int i = 0; i < 256; ++i)
+        lut[i] = uchar(255 * std::pow(i / 255.f, gamma));
+    return lut;
+}
+
+void PointOps::grayscale(QImage &image)
+{
+    if (!prepare(image))
+        return;
+    const bool isPremultiplied = image.format() == QImage::Format_ARGB32_Premultiplied;
+    auto kernel = CpuFeatures::hasAvx2() ? grayscaleRowAvx2
+        : CpuFeatures::hasSse2() ? grayscaleRowSse2 : grayscaleRowScalar;
+    forEachRow(image, [=](quint32 *row, int count) {
+        kernel(row, count, isPremultiplied);
+    });
+}
+
+void PointOps::applyLut(QImage &image, const Lut &lut)
+{
+    if (!prepare(image))
+        return;
+    // Table lookups don't vectorize without gathers, plain row-major loop is bound by memory anyway
+    const bool isPremultiplied = image.format() == QImage::Format_ARGB32_Premultiplied;
+    forEachRow(image, [&lut, isPremultiplied](quint32 *row, int count) {
+        for (int i = 0; i < count; ++i)
+        {
+            const QRgb rgb = straight(row[i], isPremultiplied);
+            row[i] = 0xff000000u | (quint32(lut[qRed(rgb)]) << 16)
+                | (quint32(lut[qGreen(rgb)]) << 8) | lut[qBlue(rgb)];
+        }
+    });
+}
+
+void PointOps::bandThreshold(QImage &image, int low, int high)
+{
+    if (!prepare(image))
+        return;
+    const bool isPremultiplied = image.format() == QImage::Format_ARGB32_Premultiplied;
+    auto kernel = CpuFeatures::hasAvx2() ? thresholdRowAvx2
+        : CpuFeatures::hasSse2() ? thresholdRowSse2 : thresholdRowScalar;
+    forEachRow(image, [=](quint32 *row, int count) {
+        kernel(row, count, low, high, isPremultiplied);
+    });
+}
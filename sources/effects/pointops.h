@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QImage>
+
+#include <array>
+
+/**
+ * @brief Per-pixel operations for effects, applied row by row.
+ *
+ * 32-bit images are processed in place by SSE2/AVX2 kernels where the CPU
+ * has them, other formats are converted to ARGB32_Premultiplied first.
+ * Results are opaque, as they were with QImage::setPixel(qRgb(...)).
+ */
+namespace PointOps
+{
+    /** @brief Lookup table applied to red, green and blue channels. */
+    using Lut = std::array<uchar, 256>;
+
+    Lut gammaLut(float gamma);
+
+    void grayscale(QImage &image);
+    void applyLut(QImage &image, const Lut &lut);
+    /**
+     * @brief Pixels with red channel in [low, high) become white, others black.
+     */
+    void bandThreshold(QImage &image, int low, int high);
+}
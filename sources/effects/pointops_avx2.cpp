@@ -0,0 +1,86 @@
+// Compiled with AVX2 enabled (see CMakeLists.txt), called only when CPU supports it.
+
+#include "pointops_p.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+
+inline bool isOpaque(__m256i pixels)
+{
+    const __m256i alphaMask = _mm256_set1_epi32(int(0xff000000));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(pixels, alphaMask), alphaMask)) == -1;
+}
+
+} // namespace
+
+void PointOps::Detail::grayscaleRowAvx2(quint32 *row, int count, bool isPremultiplied)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i weights = _mm256_set_epi16(0, WEIGHT_R, WEIGHT_G, WEIGHT_B, 0, WEIGHT_R, WEIGHT_G, WEIGHT_B,
+                                             0, WEIGHT_R, WEIGHT_G, WEIGHT_B, 0, WEIGHT_R, WEIGHT_G, WEIGHT_B);
+    const __m256i alpha = _mm256_set1_epi32(int(0xff000000));
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i *ptr = reinterpret_cast<__m256i*>(row + i);
+        const __m256i pixels = _mm256_loadu_si256(ptr);
+        if (!isOpaque(pixels))
+        {
+            grayscaleRowScalar(row + i, 8, isPremultiplied);
+            continue;
+        }
+        // Unpack and shuffle work within 128-bit lanes, so pixel order is kept per lane
+        const __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), weights);
+        const __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), weights);
+        const __m256 loF = _mm256_castsi256_ps(lo);
+        const __m256 hiF = _mm256_castsi256_ps(hi);
+        const __m256i even = _mm256_castps_si256(_mm256_shuffle_ps(loF, hiF, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m256i odd = _mm256_castps_si256(_mm256_shuffle_ps(loF, hiF, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m256i gray = _mm256_srli_epi32(_mm256_add_epi32(even, odd), 15);
+        const __m256i result = _mm256_or_si256(_mm256_or_si256(gray, _mm256_slli_epi32(gray, 8)),
+                                               _mm256_or_si256(_mm256_slli_epi32(gray, 16), alpha));
+        _mm256_storeu_si256(ptr, result);
+    }
+    grayscaleRowSse2(row + i, count - i, isPremultiplied);
+}
+
+void PointOps::Detail::thresholdRowAvx2(quint32 *row, int count, int low, int high, bool isPremultiplied)
+{
+    const __m256i lowBound = _mm256_set1_epi32(low - 1);
+    const __m256i highBound = _mm256_set1_epi32(high);
+    const __m256i channelMask = _mm256_set1_epi32(0xff);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ffffff);
+    const __m256i alpha = _mm256_set1_epi32(int(0xff000000));
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i *ptr = reinterpret_cast<__m256i*>(row + i);
+        const __m256i pixels = _mm256_loadu_si256(ptr);
+        if (!isOpaque(pixels))
+        {
+            thresholdRowScalar(row + i, 8, low, high, isPremultiplied);
+            continue;
+        }
+        const __m256i red = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), channelMask);
+        const __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(red, lowBound), _mm256_cmpgt_epi32(highBound, red));
+        _mm256_storeu_si256(ptr, _mm256_or_si256(_mm256_and_si256(inside, colorMask), alpha));
+    }
+    thresholdRowSse2(row + i, count - i, low, high, isPremultiplied);
+}
+
+#else
+
+void PointOps::Detail::grayscaleRowAvx2(quint32 *row, int count, bool isPremultiplied)
+{
+    grayscaleRowSse2(row, count, isPremultiplied);
+}
+
+void PointOps::Detail::thresholdRowAvx2(quint32 *row, int count, int low, int high, bool isPremultiplied)
+{
+    thresholdRowSse2(row, count, low, high, isPremultiplied);
+}
+
+#endif // __AVX2__
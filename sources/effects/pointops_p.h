@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Row kernels of PointOps, SIMD ones live in separate translation units
+// compiled with their instruction set enabled. Keep inline code out of here,
+// the linker may pick its AVX2 compiled copy for every caller.
+namespace PointOps
+{
+namespace Detail
+{
+    void grayscaleRowScalar(quint32 *row, int count, bool isPremultiplied);
+    void thresholdRowScalar(quint32 *row, int count, int low, int high, bool isPremultiplied);
+
+    void grayscaleRowSse2(quint32 *row, int count, bool isPremultiplied);
+    void thresholdRowSse2(quint32 *row, int count, int low, int high, bool isPremultiplied);
+
+    void grayscaleRowAvx2(quint32 *row, int count, bool isPremultiplied);
+    void thresholdRowAvx2(quint32 *row, int count, int low, int high, bool isPremultiplied);
+
+    // Luma weights in 1/32768 units, fit signed 16 bits for pmaddwd
+    enum { WEIGHT_R = 9798, WEIGHT_G = 19235, WEIGHT_B = 3735 };
+}
+}
@@ -1,84 +1,50 @@
 #include "scripteffect.h"
 
 #include "../imagearea.h"
+#include "../undocommand.h"
+#include "../scriptjobqueue.h"
 
 #include "../ScriptModel.h"
 
-#include "../dialogs/SpinnerOverlay.h"
-
-#include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrent>
-#include <QApplication>
-#include <QMainWindow>
-
-static QMainWindow* GetMainWindow()
-{
-    for (QWidget* widget : QApplication::topLevelWidgets()) {
-        if (auto* w = qobject_cast<QMainWindow*>(widget)) {
-            return w;
-        }
-    }
-    return nullptr;
-}
-
 ImageArea* ScriptEffect::applyEffect(ImageArea* imageArea)
 {
-    // 1) Prepare undo & args exactly as before
-    makeUndoCommand(imageArea);
-
     QVariantList args;
+    const bool isNewImage = imageArea == nullptr;
     if (imageArea) {
         args << *(imageArea->getImage());
         if (mFunctionInfo.usesMarkup())
             args << *(imageArea->getMarkup());
     }
-
-    // 2) Kick off the script call on a worker thread
-    auto future = QtConcurrent::run([this, args]() -> QVariant {
-        // all default params on call() will be used
-        return mScriptModel->call(mFunctionInfo.name, args);
-        });
-
-    // 3) Watch the future and drive a local event loop
-    QFutureWatcher<QVariant> watcher;
-    watcher.setFuture(future);
-
-    QEventLoop loop;
-    QObject::connect(&watcher, &QFutureWatcher<QVariant>::finished,
-        &loop, &QEventLoop::quit);
-
-    // 4) Optionally disable the UI & show spinner
-    std::unique_ptr<SpinnerOverlay> spinner;
-    const auto mainWindow = GetMainWindow();
-    if (mainWindow) {
-        mainWindow->setEnabled(false);
-        spinner.reset(new SpinnerOverlay(mainWindow));
+    else {
+        // the result of a creating function lands in its own tab
+        imageArea = initializeNewTab();
+        if (!imageArea)
+            return nullptr;
     }
 
-    // 5) Block here until the script is done
-    loop.exec();
-
-    // 6) Teardown spinner + re-enable UI (RAII + explicit)
-    spinner.reset();            // destroys the overlay (hides + stops)
-    if (mainWindow)
-        mainWindow->setEnabled(true);
-
-    // 7) Pull the result and apply it just like before
-    QVariant result = future.result();
-    if (result.canConvert<QImage>()) {
-        QImage img = result.value<QImage>();
-        if (!img.isNull()) {
-            if (!imageArea)
-                imageArea = initializeNewTab();
-
-            imageArea->setImage(img);
-            imageArea->fixSize(true);
-            imageArea->setEdited(true);
-            imageArea->update();
-        }
-    }
+    // Only the target tab is locked while the script runs on a pool thread,
+    // the result replaces its image as a single undo step
+    ScriptModel* scriptModel = mScriptModel;
+    const QString name = mFunctionInfo.name;
+    imageArea->getScriptJobs()->submit(mFunctionInfo.fullName,
+        [scriptModel, name, args](std::weak_ptr<EffectRunCallback> callback) -> QVariant {
+            return scriptModel->call(name, args, callback);
+        },
+        [isNewImage](ImageArea* target, const QVariant& result) {
+            if (!result.canConvert<QImage>())
+                return;
+            QImage img = result.value<QImage>();
+            if (img.isNull())
+                return;
+
+            // effects can change image size
+            if (!isNewImage)
+                target->pushUndoCommand(new UndoCommand(*target, nullptr, true));
+            target->setImage(img);
+            target->fixSize(true);
+            target->setEdited(true);
+            target->update();
+        });
 
-    // 8) Return the (possibly new) ImageArea
     return imageArea;
 }
@@ -0,0 +1,140 @@
+#include "floatrgb.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EASYPAINT_SSE2
+#endif
+
+namespace {
+
+inline float loadSample(const uchar *p)
+{
+    float value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uchar toByte(float value)
+{
+    value *= 255.f;
+    // Comparisons are false for NaN, which ends up as 0
+    value = value > 0.f ? value : 0.f;
+    value = value < 255.f ? value : 255.f;
+    return uchar(std::nearbyint(value));
+}
+
+void convertRowGeneric(const uchar *src, const FloatRgb::Layout &layout, uchar *dst)
+{
+    for (int x = 0; x < layout.width; ++x)
+    {
+        const uchar *pixel = src + x * layout.pixelStride;
+        for (int c = 0; c < 3; ++c)
+            dst[x * 3 + c] = toByte(loadSample(pixel + c * layout.channelStride));
+    }
+}
+
+#ifdef EASYPAINT_SSE2
+
+inline __m128i toInt32(__m128 value)
+{
+    static const __m128 scale = _mm_set1_ps(255.f);
+    value = _mm_mul_ps(value, scale);
+    // max() returns the second operand for NaN
+    value = _mm_max_ps(value, _mm_setzero_ps());
+    value = _mm_min_ps(value, scale);
+    return _mm_cvtps_epi32(value);
+}
+
+/**
+ * @brief Pixels are float triplets one after another, the row is one run of samples.
+ */
+void convertRowInterleaved(const float *src, int width, uchar *dst)
+{
+    const int count = width * 3;
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i a = toInt32(_mm_loadu_ps(src + i));
+        const __m128i b = toInt32(_mm_loadu_ps(src + i + 4));
+        const __m128i c = toInt32(_mm_loadu_ps(src + i + 8));
+        const __m128i d = toInt32(_mm_loadu_ps(src + i + 12));
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    for (; i < count; ++i)
+        dst[i] = toByte(src[i]);
+}
+
+/**
+ * @brief Each channel is a separate run of samples, pixels get interleaved on store.
+ *
+ * Every pixel is written as 4 bytes, the extra byte is overwritten by the next
+ * pixel, so the last pixel of the row is left to the scalar tail.
+ */
+void convertRowPlanar(const float *red, const float *green, const float *blue, int width, uchar *dst)
+{
+    int x = 0;
+    for (; x + 4 < width; x += 4)
+    {
+        const __m128i r = toInt32(_mm_loadu_ps(red + x));
+        const __m128i g = toInt32(_mm_loadu_ps(green + x));
+        const __m128i b = toInt32(_mm_loadu_ps(blue + x));
+        const __m128i pixels = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(b, 16)));
+        alignas(16) quint32 words[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(words), pixels);
+        for (int j = 0; j < 4; ++j)
+            memcpy(dst + (x + j) * 3, &words[j], sizeof(quint32));
+    }
+    for (; x < width; ++x)
+    {
+        dst[x * 3] = toByte(red[x]);
+        dst[x * 3 + 1] = toByte(green[x]);
+        dst[x * 3 + 2] = toByte(blue[x]);
+    }
+}
+
+#endif
+
+} // namespace
+
+QImage FloatRgb::toRgb888(const void *data, const Layout &layout)
+{
+    QImage image(layout.width, layout.height, QImage::Format_RGB888);
+    if (image.isNull())
+        return image;
+
+    const uchar *bits = static_cast<const uchar*>(data);
+    const qsizetype sampleSize = sizeof(float);
+    const bool isAligned = quintptr(bits) % sampleSize == 0 && layout.rowStride % sampleSize == 0;
+    const bool isInterleaved = isAligned && layout.pixelStride == 3 * sampleSize && layout.channelStride == sampleSize;
+    const bool isPlanar = isAligned && layout.pixelStride == sampleSize && layout.channelStride % sampleSize == 0;
+
+    for (int y = 0; y < layout.height; ++y)
+    {
+        const uchar *src = bits + y * layout.rowStride;
+        uchar *dst = image.scanLine(y);
+#ifdef EASYPAINT_SSE2
+        if (isInterleaved)
+        {
+            convertRowInterleaved(reinterpret_cast<const float*>(src), layout.width, dst);
+            continue;
+        }
+        if (isPlanar)
+        {
+            convertRowPlanar(reinterpret_cast<const float*>(src),
+                             reinterpret_cast<const float*>(src + layout.channelStride),
+                             reinterpret_cast<const float*>(src + 2 * layout.channelStride),
+                             layout.width, dst);
+            continue;
+        }
+#else
+        Q_UNUSED(isInterleaved);
+        Q_UNUSED(isPlanar);
+#endif
+        convertRowGeneric(src, layout, dst);
+    }
+    return image;
+}
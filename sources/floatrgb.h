@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QImage>
+
+/**
+ * @brief Conversion of float RGB samples in [0, 1] to 8-bit images.
+ *
+ * Layout of the source is described by byte strides, so interleaved (HWC)
+ * and planar (CHW) buffers as well as their transposed views are accepted.
+ * Both common layouts have SSE2 kernels; anything else is converted per sample.
+ */
+namespace FloatRgb
+{
+    struct Layout
+    {
+        int width;
+        int height;
+        qsizetype rowStride; /**< Bytes between rows. */
+        qsizetype pixelStride; /**< Bytes between neighbour pixels of a row. */
+        qsizetype channelStride; /**< Bytes between red, green and blue samples of a pixel. */
+    };
+
+    /**
+     * @brief Scale samples by 255, round and saturate them into Format_RGB888 image.
+     *
+     * NaN samples become 0.
+     */
+    QImage toRgb888(const void *data, const Layout &layout);
+}
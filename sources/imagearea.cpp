@@ -26,6 +26,7 @@
 #include "imagearea.h"
 #include "datasingleton.h"
 #include "undocommand.h"
+#include "scriptjobqueue.h"
 
 #include "instruments/abstractinstrument.h"
 #include "instruments/selectioninstrument.h"
@@ -45,7 +46,9 @@
 
 #include "effects/abstracteffect.h"
 
-#include "avir/avir.h"
+#include "imageresize.h"
+#include "imageloader.h"
+#include "imagesaver.h"
 
 #include <QApplication>
 #include <QPainter>
@@ -63,35 +66,45 @@
 #include <QMessageBox>
 #include <QClipboard>
 #include <QBitmap>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QtMath>
 
 namespace {
 
-QImage doResizeImage(const QImage& source, const QSize& newSize)
+const qreal MIN_ZOOM_FACTOR = 1. / 16;
+const qreal MAX_ZOOM_FACTOR = 64;
+
+/**
+ * @brief Image pixel shown by pixel of the zoomed surface, the scaled image is sampled at pixel centers.
+ */
+int surfaceToImage(int surface, qreal zoomFactor)
 {
-    int step = 0;
-    const auto format = source.format();
-    switch (format)
-    {
-    case QImage::Format_RGB32:
-    case QImage::Format_ARGB32:
-    case QImage::Format_ARGB32_Premultiplied:
-        step = 4;
-        break;
-    case QImage::Format_RGB888:
-        step = 3;
-        break;
-    case QImage::Format_Grayscale8:
-        step = 1;
-        break;
-    default: return source.scaled(newSize);
-    }
+    return qFloor((surface + 0.5) / zoomFactor);
+}
 
-    avir::CImageResizer<> ImageResizer(8);
-    QImage result(newSize, format);
-    ImageResizer.resizeImage(source.bits(), source.size().width(), source.size().height(), 
-        source.bytesPerLine(), result.bits(), newSize.width(), newSize.height(), result.bytesPerLine(), step, 0);
+/**
+ * @brief First pixel of the zoomed surface showing image pixel.
+ */
+int imageToSurface(int pixel, qreal zoomFactor)
+{
+    int surface = qCeil(pixel * zoomFactor - 0.5);
+    // On exact pixel borders rounding may go either way, agree with surfaceToImage()
+    if (surfaceToImage(surface, zoomFactor) < pixel)
+        ++surface;
+    else if (surfaceToImage(surface - 1, zoomFactor) >= pixel)
+        --surface;
+    return surface;
+}
 
-    return result;
+QRegion markupToRegion(const QImage& markup)
+{
+    // Convert monochrome mask to a QBitmap and then QRegion:
+    QImage monoMask = markup.convertToFormat(QImage::Format_Mono);
+    QBitmap bitmapMask = QBitmap::fromImage(monoMask);
+    return QRegion(bitmapMask);
 }
 
 void doResizeCanvas(ImageArea *mPImageArea, int width, int height, bool flag, bool resizeWindow)
@@ -154,6 +167,17 @@ ImageArea::ImageArea(bool openFile, bool askCanvasSize, const QString &filePath,
 
     mUndoStack = new QUndoStack(this);
     mUndoStack->setUndoLimit(DataSingleton::Instance()->getHistoryDepth());
+    connect(mUndoStack, SIGNAL(indexChanged(int)), this, SLOT(updateUndoMemoryUsage()));
+
+    mSaver = new ImageSaver(this);
+    connect(mSaver, SIGNAL(finished(bool)), this, SLOT(finishSaving(bool)));
+
+    mAntsTimer = new QTimer(this);
+    mAntsTimer->setInterval(150);
+    connect(mAntsTimer, SIGNAL(timeout()), this, SLOT(advanceAnts()));
+
+    mScriptJobs = new ScriptJobQueue(this);
+    connect(mScriptJobs, SIGNAL(busyChanged(bool)), this, SIGNAL(sendBusyChanged(bool)));
 
     if(openFile)
     {
@@ -256,23 +280,58 @@ void ImageArea::open()
 
 void ImageArea::open(const QString &filePath)
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    if(mImage.load(filePath))
+    mFilePath = filePath;
+    fixSize();
+
+    mLoadingPanel = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(mLoadingPanel);
+    QLabel *label = new QLabel(tr("Loading \"%1\"...").arg(getFileName()), mLoadingPanel);
+    QProgressBar *progressBar = new QProgressBar(mLoadingPanel);
+    progressBar->setRange(0, 100);
+    QPushButton *cancelButton = new QPushButton(tr("Cancel"), mLoadingPanel);
+    layout->addWidget(label);
+    layout->addWidget(progressBar);
+    layout->addWidget(cancelButton, 0, Qt::AlignRight);
+    mLoadingPanel->setAutoFillBackground(true);
+    mLoadingPanel->adjustSize();
+    mLoadingPanel->move(10, 10);
+    mLoadingPanel->show();
+
+    mLoader = new ImageLoader(filePath, this);
+    connect(mLoader, SIGNAL(progressChanged(int)), progressBar, SLOT(setValue(int)));
+    connect(mLoader, SIGNAL(finished(bool)), this, SLOT(finishLoading(bool)));
+    connect(cancelButton, SIGNAL(clicked()), mLoader, SLOT(cancel()));
+    mLoader->start();
+}
+
+void ImageArea::finishLoading(bool isSuccess)
+{
+    if (isSuccess)
     {
-        mImage = mImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        mImage = mLoader->getImage();
+        mPyramid.clear();
         mMarkup = QImage(mImage.size(), QImage::Format_Grayscale8);
         mMarkup.fill(Qt::white);
-        mFilePath = filePath;
-        DataSingleton::Instance()->setLastFilePath(filePath);
+        DataSingleton::Instance()->setLastFilePath(mFilePath);
         fixSize();
-        QApplication::restoreOverrideCursor();
     }
-    else
+    else if (!mLoader->isCancelled())
     {
-        qDebug()<<QString("Can't open file %1").arg(filePath);
-        QApplication::restoreOverrideCursor();
-        QMessageBox::warning(this, tr("Error opening file"), tr("Can't open file \"%1\".").arg(filePath));
+        qDebug()<<QString("Can't open file %1: %2").arg(mFilePath, mLoader->getErrorString());
+        QMessageBox::warning(this, tr("Error opening file"), tr("Can't open file \"%1\".").arg(mFilePath));
     }
+
+    mLoader->deleteLater();
+    mLoader = nullptr;
+    mLoadingPanel->deleteLater();
+    mLoadingPanel = nullptr;
+    update();
+    emit sendLoadingFinished(isSuccess);
+}
+
+bool ImageArea::isBusy() const
+{
+    return isLoading() || mScriptJobs->isBusy();
 }
 
 bool ImageArea::save()
@@ -282,12 +341,11 @@ bool ImageArea::save()
         return saveAs();
     }
     clearSelection();
-    if (mImage.save(mFilePath))
+    if (!writeImage(mFilePath))
     {
         QMessageBox::warning(this, tr("Error saving file"), tr("Can't save file \"%1\".").arg(mFilePath));
         return false;
     }
-    mIsEdited = false;
     return true;
 }
 
@@ -327,10 +385,9 @@ bool ImageArea::saveAs()
             filePath += '.' + extension;
         }
 
-        if(mImage.save(filePath, extension.toLatin1().data()))
+        if(writeImage(filePath, extension.toLatin1()))
         {
             mFilePath = filePath;
-            mIsEdited = false;
         }
         else
         {
@@ -344,11 +401,47 @@ bool ImageArea::saveAs()
 
 void ImageArea::autoSave()
 {
-    if(mIsEdited && !mFilePath.isEmpty() && DataSingleton::Instance()->getIsAutoSave())
+    if(!isLoading() && !mIsSaving && mIsEdited && !mFilePath.isEmpty() && DataSingleton::Instance()->getIsAutoSave())
     {
-        if(mImage.save(mFilePath)) {
-            mIsEdited = false;
+        // Saving of older snapshot is still running, take a fresh one after it
+        if (mSaver->isBusy())
+        {
+            mIsAutoSavePending = true;
+            return;
         }
+        mSavedImageKey = mImage.cacheKey();
+        mSaver->save(mImage, mFilePath);
+    }
+}
+
+bool ImageArea::writeImage(const QString &filePath, const QByteArray &format)
+{
+    mIsSaving = true;
+    mIsAutoSavePending = false;
+    mSaver->waitForFinished();
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    mSavedImageKey = mImage.cacheKey();
+    mSaver->save(mImage, filePath, format);
+    const bool isSuccess = mSaver->waitForFinished();
+    QApplication::restoreOverrideCursor();
+
+    mIsSaving = false;
+    return isSuccess;
+}
+
+void ImageArea::finishSaving(bool isSuccess)
+{
+    // Any edit since the snapshot was taken detaches the image and changes its key
+    if (isSuccess && mImage.cacheKey() == mSavedImageKey)
+        mIsEdited = false;
+    if (!isSuccess)
+        qDebug()<<QString("Can't save file: %1").arg(mSaver->getErrorString());
+
+    if (mIsAutoSavePending)
+    {
+        mIsAutoSavePending = false;
+        autoSave();
     }
 }
 
@@ -370,11 +463,12 @@ void ImageArea::print()
 
 void ImageArea::resizeImage()
 {
-    ResizeDialog resizeDialog(getImage()->size(), qobject_cast<QWidget*>(parent()));
+    ResizeDialog resizeDialog(getImage()->size(), qobject_cast<QWidget*>(parent()), true);
     if (resizeDialog.exec() == QDialog::Accepted)
     {
-        setImage(doResizeImage(*getImage(), resizeDialog.getNewSize())); //mPImageArea->getImage()->scaled(resizeDialog.getNewSize()));
-        setMarkup(doResizeImage(*getMarkup(), resizeDialog.getNewSize()));
+        const ImageResize::Mode mode = resizeDialog.getResizeMode();
+        setImage(ImageResize::resize(*getImage(), resizeDialog.getNewSize(), mode));
+        setMarkup(ImageResize::resize(*getMarkup(), resizeDialog.getNewSize(), mode));
         fixSize(true);
         setEdited(true);
     }
@@ -398,8 +492,7 @@ void ImageArea::rotateImage(bool flag)
     transform.rotate(flag? 90 : -90);
     setImage(getImage()->transformed(transform));
     setMarkup(getMarkup()->transformed(transform));
-    resize(getImage()->rect().right() * mZoomFactor + 6, getImage()->rect().bottom() * mZoomFactor + 6);
-    update();
+    fixSize();
     setEdited(true);
     clearSelection();
 
@@ -437,7 +530,12 @@ void ImageArea::cutImage()
 
 void ImageArea::mousePressEvent(QMouseEvent *event)
 {
-    const auto pos = event->pos() / getZoomFactor();
+    if (isBusy())
+        return;
+    // Nothing to edit on the area around the canvas
+    if (!QRect(QPoint(0, 0), getCanvasSize()).contains(event->pos() + mScrollOffset))
+        return;
+    const auto pos = mapToImage(event->pos());
 
     if(event->button() == Qt::LeftButton &&
         pos.x() < mImage.rect().right() + 6 &&
@@ -459,7 +557,9 @@ void ImageArea::mousePressEvent(QMouseEvent *event)
 
 void ImageArea::mouseMoveEvent(QMouseEvent *event)
 {
-    const auto pos = event->pos() / getZoomFactor();
+    if (isBusy())
+        return;
+    const auto pos = mapToImage(event->pos());
 
     InstrumentsEnum instrument = DataSingleton::Instance()->getInstrument();
     mInstrumentHandler = mInstrumentsHandlers.at(
@@ -502,6 +602,8 @@ void ImageArea::mouseMoveEvent(QMouseEvent *event)
 
 void ImageArea::mouseReleaseEvent(QMouseEvent *event)
 {
+    if (isBusy())
+        return;
     if(mIsResize)
     {
         fixSize();
@@ -521,33 +623,204 @@ void ImageArea::paintEvent(QPaintEvent *event)
 {
     QPainter painter(this);
 
-    if (mImage.isNull())
+    // Area around the canvas, the view only scrolls what is on it
+    painter.fillRect(event->rect(), palette().dark());
+    painter.translate(-mScrollOffset);
+    const QSize canvasSize = getCanvasSize();
+
+    if (mImage.isNull() || isLoading())
     {
         painter.setBrush(QBrush(QPixmap(":media/textures/transparent.jpg")));
-        painter.drawRect(rect());
+        painter.drawRect(QRect(QPoint(0, 0), canvasSize));
     }
     else
     {
-        painter.save();
-        painter.scale(mZoomFactor, mZoomFactor);
-        painter.drawImage(QPoint(0, 0), mImage);
+        // Composite only the exposed part of the image
+        const QRect exposedRect = event->rect().translated(mScrollOffset);
+        const QRect sourceRect = QRectF(QPointF(exposedRect.topLeft()) / mZoomFactor,
+                                        QSizeF(exposedRect.size()) / mZoomFactor)
+                                     .toAlignedRect().intersected(mImage.rect());
+        if (!sourceRect.isEmpty())
+        {
+            painter.save();
+            painter.scale(mZoomFactor, mZoomFactor);
+            const int level = DisplayPyramid::levelForZoom(mZoomFactor);
+            if (level > 0)
+            {
+                // Zoomed out: sample the nearest downscaled copy, it is cheaper and doesn't alias
+                const QImage &levelImage = mPyramid.getLevel(mImage, level, sourceRect);
+                const QRectF levelRect(QPointF(sourceRect.topLeft()) / (1 << level),
+                                       QSizeF(sourceRect.size()) / (1 << level));
+                painter.drawImage(QRectF(sourceRect), levelImage, levelRect);
+            }
+            else
+            {
+                painter.drawImage(sourceRect.topLeft(), mImage, sourceRect);
+            }
 
-        // Convert monochrome mask to a QBitmap and then QRegion:
-        QImage monoMask = mMarkup.convertToFormat(QImage::Format_Mono);
-        QBitmap bitmapMask = QBitmap::fromImage(monoMask);
-        QRegion clipRegion(bitmapMask);
+            painter.setClipRegion(getMarkupRegion().intersected(sourceRect));
 
-        painter.setClipRegion(clipRegion);
+            painter.fillRect(sourceRect, DataSingleton::Instance()->getPrimaryColor());
 
-        painter.fillRect(mImage.rect(), DataSingleton::Instance()->getPrimaryColor());
+            if (!mOverlay.isNull())
+            {
+                painter.setClipping(false);
+                painter.drawImage(mOverlayPos, mOverlay);
+            }
 
-        painter.restore();
+            painter.restore();
+        }
     }
 
     painter.setPen(Qt::NoPen);
     painter.setBrush(QBrush(Qt::black));
-    auto start = mImage.rect().size() * mZoomFactor;
-    painter.drawRect(QRect(start.width(), start.height(), 6, 6));
+    painter.drawRect(QRect(canvasSize.width() - 6, canvasSize.height() - 6, 6, 6));
+    painter.resetTransform();
+
+    if (!mSelectionChrome.isNull() && !isLoading())
+    {
+        // Marching ants: dashes over a solid line stay visible on any image
+        const QRect border = getSelectionChromeRect();
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(Qt::white, 0));
+        painter.drawRect(border);
+        QPen antsPen(Qt::black, 0, Qt::CustomDashLine);
+        antsPen.setDashPattern({ 4, 4 });
+        antsPen.setDashOffset(mAntsOffset);
+        painter.setPen(antsPen);
+        painter.drawRect(border);
+
+        painter.setPen(QPen(Qt::black, 0));
+        painter.setBrush(QBrush(Qt::white));
+        // Outline is drawn on the rect edges, so it ends one pixel beyond width and height
+        painter.drawRect(getSelectionHandleRect().adjusted(0, 0, -1, -1));
+    }
+}
+
+QRect ImageArea::getSelectionChromeRect() const
+{
+    const QPoint topLeft = mapFromImage(mSelectionChrome.topLeft());
+    const QPoint bottomRight = mapFromImage(mSelectionChrome.bottomRight() + QPoint(1, 1));
+    return QRect(topLeft, bottomRight - QPoint(1, 1));
+}
+
+QRect ImageArea::getSelectionHandleRect() const
+{
+    if (mSelectionChrome.isNull())
+        return QRect();
+    return QRect(getSelectionChromeRect().bottomRight() + QPoint(1, 1), QSize(6, 6));
+}
+
+void ImageArea::setSelectionChrome(const QRect &rect)
+{
+    if (rect == mSelectionChrome)
+        return;
+    clearSelectionChrome();
+    mSelectionChrome = rect;
+    update(getSelectionChromeRect().adjusted(-1, -1, 1, 1) | getSelectionHandleRect());
+    mAntsTimer->start();
+}
+
+void ImageArea::clearSelectionChrome()
+{
+    if (mSelectionChrome.isNull())
+        return;
+    update(getSelectionChromeRect().adjusted(-1, -1, 1, 1) | getSelectionHandleRect());
+    mSelectionChrome = QRect();
+    mAntsTimer->stop();
+}
+
+void ImageArea::advanceAnts()
+{
+    mAntsOffset = (mAntsOffset + 1) % 8;
+    // Only the border strip changes
+    const QRect border = getSelectionChromeRect();
+    update(QRegion(border.adjusted(-1, -1, 1, 1)).subtracted(QRegion(border.adjusted(1, 1, -1, -1))));
+}
+
+void ImageArea::setImage(const QImage &image)
+{
+    mImage = image;
+    mPyramid.invalidate(mImage.rect());
+}
+
+void ImageArea::setMarkup(const QImage& image)
+{
+    // Instruments restore stashed markup on every mouse move, so keep the
+    // region of the previous state around instead of rebuilding it.
+    const qint64 key = image.cacheKey();
+    if (key != mMarkupRegionKey && key == mPrevMarkupRegionKey)
+    {
+        std::swap(mMarkupRegion, mPrevMarkupRegion);
+        std::swap(mMarkupRegionKey, mPrevMarkupRegionKey);
+    }
+    mMarkup = image;
+}
+
+void ImageArea::updateMarkupRegion(const QRect &rect)
+{
+    if (mMarkupRegionKey == 0)
+        return; // region is rebuilt from scratch on next paint
+
+    const QRect dirtyRect = rect.normalized().intersected(mMarkup.rect());
+
+    mPrevMarkupRegion = mMarkupRegion;
+    mPrevMarkupRegionKey = mMarkupRegionKey;
+
+    if (!dirtyRect.isEmpty())
+    {
+        mMarkupRegion = mMarkupRegion.subtracted(dirtyRect)
+            .united(markupToRegion(mMarkup.copy(dirtyRect)).translated(dirtyRect.topLeft()));
+    }
+    mMarkupRegionKey = mMarkup.cacheKey();
+}
+
+void ImageArea::updateImageRect(const QRect &rect)
+{
+    mPyramid.invalidate(rect);
+    updateViewRect(rect);
+}
+
+void ImageArea::updateViewRect(const QRect &rect)
+{
+    const QRectF widgetRect(QPointF(rect.topLeft()) * mZoomFactor - QPointF(mScrollOffset),
+                            QSizeF(rect.size()) * mZoomFactor);
+    update(widgetRect.toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+void ImageArea::setOverlay(const QImage &overlay, const QPoint &pos)
+{
+    const QRect oldRect(mOverlayPos, mOverlay.size());
+    mOverlay = overlay;
+    mOverlayPos = pos;
+    updateViewRect(QRect(pos, overlay.size()).united(oldRect));
+}
+
+void ImageArea::clearOverlay()
+{
+    if (mOverlay.isNull())
+        return;
+    updateViewRect(QRect(mOverlayPos, mOverlay.size()));
+    mOverlay = QImage();
+}
+
+const QRegion& ImageArea::getMarkupRegion()
+{
+    const qint64 key = mMarkup.cacheKey();
+    if (key != mMarkupRegionKey)
+    {
+        if (key == mPrevMarkupRegionKey)
+        {
+            std::swap(mMarkupRegion, mPrevMarkupRegion);
+            std::swap(mMarkupRegionKey, mPrevMarkupRegionKey);
+        }
+        else
+        {
+            mMarkupRegion = markupToRegion(mMarkup);
+            mMarkupRegionKey = key;
+        }
+    }
+    return mMarkupRegion;
 }
 
 void ImageArea::restoreCursor()
@@ -598,28 +871,22 @@ void ImageArea::restoreCursor()
 
 bool ImageArea::setZoomFactor(qreal factor)
 {
-    auto zoomFactor = mZoomFactor * factor;
-    if (zoomFactor <= 0.25)
-    {
-        if (mZoomFactor == 0.25)
-        {
-            return false;
-        }
-        mZoomFactor = 0.25;
-    }
-    else if (zoomFactor >= 8)
-    {
-        if (mZoomFactor == 8)
-        {
-            return false;
-        }
-        mZoomFactor = 8;
-    }
-    else
+    return setZoomFactor(factor, rect().center());
+}
+
+bool ImageArea::setZoomFactor(qreal factor, const QPoint &anchor)
+{
+    const qreal zoomFactor = qBound(MIN_ZOOM_FACTOR, mZoomFactor * factor, MAX_ZOOM_FACTOR);
+    if (qFuzzyCompare(zoomFactor, mZoomFactor))
     {
-        mZoomFactor = zoomFactor;
+        return false;
     }
 
+    // Keep the surface point under anchor in place, the view clamps the offset
+    const QPointF anchorPos = QPointF(anchor + mScrollOffset) * (zoomFactor / mZoomFactor);
+    mScrollOffset = (anchorPos - QPointF(anchor)).toPoint();
+    mZoomFactor = zoomFactor;
+
     fixSize(true);
 
     return true;
@@ -627,7 +894,8 @@ bool ImageArea::setZoomFactor(qreal factor)
 
 void ImageArea::fixSize(bool cleanUp /*= false*/)
 {
-    resize(mImage.width() * mZoomFactor + 6, mImage.height() * mZoomFactor + 6);
+    emit sendCanvasSizeChanged();
+    update();
     if (cleanUp)
     {
         emit sendNewImageSize(mImage.size());
@@ -635,6 +903,33 @@ void ImageArea::fixSize(bool cleanUp /*= false*/)
     }
 }
 
+QSize ImageArea::getCanvasSize() const
+{
+    return QSize(qCeil(mImage.width() * mZoomFactor) + 6, qCeil(mImage.height() * mZoomFactor) + 6);
+}
+
+QPoint ImageArea::mapToImage(const QPoint &pos) const
+{
+    const QPoint surfacePos = pos + mScrollOffset;
+    return QPoint(surfaceToImage(surfacePos.x(), mZoomFactor), surfaceToImage(surfacePos.y(), mZoomFactor));
+}
+
+QPoint ImageArea::mapFromImage(const QPoint &pos) const
+{
+    return QPoint(imageToSurface(pos.x(), mZoomFactor), imageToSurface(pos.y(), mZoomFactor)) - mScrollOffset;
+}
+
+void ImageArea::setScrollOffset(const QPoint &offset)
+{
+    const QPoint delta = mScrollOffset - offset;
+    if (delta.isNull())
+        return;
+    mScrollOffset = offset;
+    // Move pixels already on screen, only the uncovered strip is painted;
+    // the rect keeps child widgets such as the loading panel in place.
+    scroll(delta.x(), delta.y(), rect());
+}
+
 void ImageArea::drawCursor()
 {
     QPainter painter;
@@ -780,7 +1075,32 @@ void ImageArea::clearSelection()
 void ImageArea::pushUndoCommand(UndoCommand *command)
 {
     if(command != 0)
+    {
+        // Current top of the stack is complete now, keep only the tiles it changed
+        const int index = mUndoStack->index();
+        if (index > 0)
+        {
+            if (auto top = dynamic_cast<const UndoCommand*>(mUndoStack->command(index - 1)))
+                const_cast<UndoCommand*>(top)->compact();
+        }
         mUndoStack->push(command);
+    }
+}
+
+qint64 ImageArea::getUndoMemoryUsage() const
+{
+    qint64 result = 0;
+    for (int i = 0; i < mUndoStack->count(); ++i)
+    {
+        if (auto command = dynamic_cast<const UndoCommand*>(mUndoStack->command(i)))
+            result += command->memoryUsage();
+    }
+    return result;
+}
+
+void ImageArea::updateUndoMemoryUsage()
+{
+    emit sendUndoMemoryUsage(getUndoMemoryUsage());
 }
 
 bool ImageArea::isMarkupMode()
@@ -27,9 +27,11 @@
 #define IMAGEAREA_H
 
 #include "easypaintenums.h"
+#include "displaypyramid.h"
 
 #include <QWidget>
 #include <QImage>
+#include <QRegion>
 
 QT_BEGIN_NAMESPACE
 class QUndoStack;
@@ -38,6 +40,10 @@ QT_END_NAMESPACE
 class UndoCommand;
 class AbstractInstrument;
 class AbstractEffect;
+class ImageLoader;
+class ImageSaver;
+class ScriptJobQueue;
+class QTimer;
 
 /**
  * @brief Base class which contains view image and controller for painting
@@ -96,9 +102,37 @@ public:
     QString getFileName() { return (mFilePath.isEmpty() ? mFilePath :
                                     mFilePath.split('/').last()); }
     QImage* getImage() { return &mImage; }
-    void setImage(const QImage &image) { mImage = image; }
+    void setImage(const QImage &image);
     QImage* getMarkup() { return &mMarkup; }
-    void setMarkup(const QImage& image) { mMarkup = image; }
+    void setMarkup(const QImage& image);
+    /**
+     * @brief Refresh cached markup clip region after markup was painted.
+     *
+     * @param rect Markup area touched by the last edit.
+     */
+    void updateMarkupRegion(const QRect &rect);
+    /**
+     * @brief Schedule repaint of the image area only, after its pixels were changed in place.
+     *
+     * @param rect Touched area in image coordinates, pen width included.
+     */
+    void updateImageRect(const QRect &rect);
+    /**
+     * @brief Show transient layer over the image, e.g. shape preview before it is committed.
+     *
+     * @param overlay Premultiplied ARGB image covering the touched area only.
+     * @param pos Position of the overlay in image coordinates.
+     */
+    void setOverlay(const QImage &overlay, const QPoint &pos);
+    void clearOverlay();
+    /**
+     * @brief Show selection border with marching ants and resize handle over the image.
+     *
+     * Chrome is drawn at screen resolution and never touches image pixels.
+     * @param rect Selected pixels in image coordinates.
+     */
+    void setSelectionChrome(const QRect &rect);
+    void clearSelectionChrome();
     /**
      * @brief Set flag which shows that image edited.
      *
@@ -111,6 +145,18 @@ public:
      * @return bool Flag.
      */
     bool getEdited() { return mIsEdited; }
+    /**
+     * @brief Whether image file is still decoded in background, image area is a placeholder until then.
+     */
+    bool isLoading() const { return mLoader != nullptr; }
+    /**
+     * @brief Whether image can't be edited now: it is loading or script jobs will replace it.
+     */
+    bool isBusy() const;
+    /**
+     * @brief Script effects queued for this image, their results land here.
+     */
+    ScriptJobQueue *getScriptJobs() { return mScriptJobs; }
     /**
      * @brief applyEffect Apply effect for image.
      * @param effect Name of affect for apply.
@@ -122,12 +168,44 @@ public:
      */
     void restoreCursor();
     /**
-     * @brief Zoom image
+     * @brief Zoom image keeping the center of the view in place.
      *
      * @param factor Scale factor
      */
     bool setZoomFactor(qreal factor);
+    /**
+     * @brief Zoom image keeping the point under anchor in place.
+     *
+     * @param factor Scale factor
+     * @param anchor Position in widget coordinates, e.g. mouse click.
+     */
+    bool setZoomFactor(qreal factor, const QPoint &anchor);
     qreal getZoomFactor() { return mZoomFactor; }
+    /**
+     * @brief Map widget position, e.g. of mouse event, to image pixel.
+     */
+    QPoint mapToImage(const QPoint &pos) const;
+    /**
+     * @brief Map image pixel to its top left corner in widget coordinates.
+     *
+     * At zoom factor 1 or above mapToImage() maps the result back to the same pixel.
+     */
+    QPoint mapFromImage(const QPoint &pos) const;
+    /**
+     * @brief Resize handle of the selection in widget coordinates, null if nothing is selected.
+     */
+    QRect getSelectionHandleRect() const;
+    /**
+     * @brief Size of zoomed image with resize handle, the virtual surface scrolled by the view.
+     */
+    QSize getCanvasSize() const;
+    /**
+     * @brief Scroll virtual surface, only the part of it which fits the widget is painted.
+     *
+     * @param offset Position of widget top left corner on the surface.
+     */
+    void setScrollOffset(const QPoint &offset);
+    QPoint getScrollOffset() const { return mScrollOffset; }
     
     void fixSize(bool cleanUp = false);
     
@@ -171,6 +249,10 @@ public:
      *
      */
     void pushUndoCommand(UndoCommand *command);
+    /**
+     * @brief Bytes held by undo stack of this image.
+     */
+    qint64 getUndoMemoryUsage() const;
     
 private:
     /**
@@ -184,11 +266,18 @@ private:
      */
     void open();
     /**
-     * @brief Open file from file.
+     * @brief Start loading file in background, area shows progress until it is decoded.
      *
      * @param filePath File path
      */
     void open(const QString &filePath);
+    /**
+     * @brief Save snapshot of image on worker, processing events until it is written.
+     *
+     * @param format Image format, deduced from file suffix if empty.
+     * @return returns true in case of success
+     */
+    bool writeImage(const QString &filePath, const QByteArray &format = QByteArray());
     /**
      * @brief Draw cursor for instruments 'pencil' and 'lastic', that depends on pencil's width.
      *
@@ -199,9 +288,34 @@ private:
      *
      */
     void makeFormatsFilters();
+    /**
+     * @brief Get clip region of markup strokes, rebuilding it if markup was replaced.
+     *
+     */
+    const QRegion& getMarkupRegion();
+    /**
+     * @brief Selection border in widget coordinates, the resize handle is drawn outside of it.
+     *
+     */
+    QRect getSelectionChromeRect() const;
+    /**
+     * @brief Schedule repaint of area given in image coordinates, image pixels stay the same.
+     *
+     */
+    void updateViewRect(const QRect &rect);
 
     QImage mImage;  /**< Main image. */
+    DisplayPyramid mPyramid; /**< Downscaled copies of mImage drawn when zoomed out. */
     QImage mMarkup;
+    QRegion mMarkupRegion; /**< Cached clip region built from mMarkup. */
+    qint64 mMarkupRegionKey = 0; /**< Cache key of markup the region corresponds to. */
+    QRegion mPrevMarkupRegion; /**< Region of markup before last edit, reused by applyStash. */
+    QImage mOverlay; /**< Transient layer composited over the image by paintEvent. */
+    QPoint mOverlayPos;
+    QRect mSelectionChrome; /**< Selected pixels shown with marching ants, null if none. */
+    QTimer *mAntsTimer;
+    int mAntsOffset = 0;
+    qint64 mPrevMarkupRegionKey = 0;
 
     QString mFilePath; /**< Path where located image. */
     QString mOpenFilter; /**< Supported open formats filter. */
@@ -211,10 +325,18 @@ private:
     QPixmap *mPixmap;
     QCursor *mCurrentCursor;
     qreal mZoomFactor;
+    QPoint mScrollOffset; /**< Position of widget on the zoomed image surface. */
     QUndoStack *mUndoStack;
     AbstractInstrument *mInstrumentHandler;
     QVector<AbstractInstrument*> mInstrumentsHandlers;
     AbstractEffect *mEffectHandler;
+    ImageLoader *mLoader = nullptr;
+    QWidget *mLoadingPanel = nullptr; /**< Progress and cancel button shown while loading. */
+    ImageSaver *mSaver;
+    ScriptJobQueue *mScriptJobs;
+    qint64 mSavedImageKey = 0; /**< Cache key of image snapshot being saved. */
+    bool mIsSaving = false; /**< Explicit save is waiting for the saver. */
+    bool mIsAutoSavePending = false; /**< Autosave was requested while saver was busy. */
 
 signals:
     /**
@@ -250,9 +372,33 @@ signals:
      *
      */
     void sendEnableSelectionInstrument(bool enable);
+    /**
+     * @brief Send memory used by undo stack to status bar.
+     *
+     */
+    void sendUndoMemoryUsage(qint64 bytes);
+    /**
+     * @brief Send signal when background loading is done, failed or cancelled.
+     *
+     */
+    void sendLoadingFinished(bool isSuccess);
+    /**
+     * @brief Send signal when image gets locked or unlocked by script jobs.
+     *
+     */
+    void sendBusyChanged(bool isBusy);
+    /**
+     * @brief Send signal when zoomed image size changes and the view must update scroll bars.
+     *
+     */
+    void sendCanvasSizeChanged();
     
 private slots:
     void autoSave();
+    void advanceAnts();
+    void updateUndoMemoryUsage();
+    void finishLoading(bool isSuccess);
+    void finishSaving(bool isSuccess);
 
 protected:
     void mousePressEvent(QMouseEvent *event);
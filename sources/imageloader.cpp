@@ -0,0 +1,137 @@
+#include "imageloader.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
+#include <functional>
+
+struct ImageLoader::State
+{
+    std::atomic<bool> isCancelled{false};
+    std::atomic<int> progress{0};
+};
+
+namespace {
+
+/**
+ * @brief File which tracks read position for progress and stops reading on cancel.
+ */
+class ProgressFile : public QFile
+{
+public:
+    using QFile::QFile;
+
+    std::function<bool(qint64 offset)> onRead; /**< Returns false to abort reading. */
+
+    bool seek(qint64 pos) override
+    {
+        if (!QFile::seek(pos))
+            return false;
+        mOffset = pos;
+        return true;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        if (onRead && !onRead(mOffset))
+            return -1;
+        const qint64 count = QFile::readData(data, maxSize);
+        if (count > 0)
+            mOffset += count;
+        return count;
+    }
+
+private:
+    qint64 mOffset = 0;
+};
+
+} // namespace
+
+ImageLoader::ImageLoader(const QString &filePath, QObject *parent) :
+    QObject(parent), mFilePath(filePath), mState(std::make_shared<State>())
+{
+    mProgressTimer = new QTimer(this);
+    mProgressTimer->setInterval(100);
+    connect(mProgressTimer, SIGNAL(timeout()), this, SLOT(pollProgress()));
+    connect(&mWatcher, SIGNAL(finished()), this, SLOT(decodingFinished()));
+}
+
+ImageLoader::~ImageLoader()
+{
+    mState->isCancelled = true;
+}
+
+void ImageLoader::start()
+{
+    mProgressTimer->start();
+    mWatcher.setFuture(QtConcurrent::run(&ImageLoader::decode, mFilePath, mState));
+}
+
+void ImageLoader::cancel()
+{
+    mState->isCancelled = true;
+}
+
+bool ImageLoader::isCancelled() const
+{
+    return mState->isCancelled;
+}
+
+void ImageLoader::pollProgress()
+{
+    const int progress = mState->progress;
+    if (progress != mProgress)
+    {
+        mProgress = progress;
+        emit progressChanged(progress);
+    }
+}
+
+void ImageLoader::decodingFinished()
+{
+    mProgressTimer->stop();
+    Result result = mWatcher.result();
+    mImage = result.image;
+    mErrorString = result.errorString;
+    if (!isCancelled())
+        pollProgress();
+    emit finished(!isCancelled() && !mImage.isNull());
+}
+
+ImageLoader::Result ImageLoader::decode(const QString &filePath, std::shared_ptr<State> state)
+{
+    Result result;
+    ProgressFile file(filePath);
+    const qint64 fileSize = qMax<qint64>(file.size(), 1);
+    file.onRead = [&](qint64 offset) {
+        const int progress = int(qMin<qint64>(offset * 100 / fileSize, 100));
+        if (progress > state->progress)
+            state->progress = progress;
+        return !state->isCancelled;
+    };
+    // Seeks must reach the file directly for the offset to stay exact
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+    {
+        result.errorString = file.errorString();
+        return result;
+    }
+
+    // Same format lookup as QImage::load(): suffix first, then content
+    QImageReader reader(&file, QFileInfo(filePath).suffix().toLatin1());
+    QImage image;
+    if (!reader.read(&image))
+    {
+        result.errorString = reader.errorString();
+        return result;
+    }
+    if (state->isCancelled)
+        return result;
+    state->progress = 100;
+    result.image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    return result;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+class QTimer;
+
+/**
+ * @brief Decodes image file on a thread pool worker.
+ *
+ * Reading goes through QImageReader on a file device which reports how much of
+ * the file was consumed and fails further reads once loading was cancelled.
+ * Several loaders started at once decode in parallel.
+ */
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageLoader(const QString &filePath, QObject *parent = nullptr);
+    /**
+     * @brief Cancels decoding still in progress, the worker drops its result.
+     */
+    ~ImageLoader();
+
+    void start();
+
+    QString getFilePath() const { return mFilePath; }
+    bool isCancelled() const;
+    /**
+     * @brief Decoded image converted to ARGB32_Premultiplied, valid after finished(true).
+     */
+    QImage getImage() const { return mImage; }
+    QString getErrorString() const { return mErrorString; }
+
+public slots:
+    void cancel();
+
+signals:
+    /**
+     * @brief Part of the file read so far, in percents.
+     */
+    void progressChanged(int percent);
+    void finished(bool isSuccess);
+
+private slots:
+    void pollProgress();
+    void decodingFinished();
+
+private:
+    struct State;
+    struct Result
+    {
+        QImage image;
+        QString errorString;
+    };
+
+    static Result decode(const QString &filePath, std::shared_ptr<State> state);
+
+    QString mFilePath;
+    std::shared_ptr<State> mState; /**< Shared with the worker, outlives loader if needed. */
+    QFutureWatcher<Result> mWatcher;
+    QTimer *mProgressTimer;
+    int mProgress = -1;
+    QImage mImage;
+    QString mErrorString;
+};
@@ -0,0 +1,91 @@
+#include "imageresize.h"
+#include "imageresize_p.h"
+#include "cpufeatures.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QThreadPool>
+#include <QVector>
+
+#include <numeric>
+#include <vector>
+
+#include "avir/avir.h"
+#include "avir/lancir.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include "avir/avir_float4_sse.h"
+#define EASYPAINT_AVIR_SSE
+#endif
+
+namespace {
+#include "imageresize_threadpool.h"
+}
+
+int ImageResize::Detail::suggestedThreadCount()
+{
+    return qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+}
+
+void ImageResize::Detail::parallelFor(int count, void *context, Task task)
+{
+    if (count == 1)
+    {
+        task(context, 0);
+        return;
+    }
+    QVector<int> indices(count);
+    std::iota(indices.begin(), indices.end(), 0);
+    // Calling thread takes part too, so this is safe from pool threads (effect previews)
+    QtConcurrent::blockingMap(indices, [=](int index) { task(context, index); });
+}
+
+QImage ImageResize::resize(const QImage &source, const QSize &newSize, Mode mode)
+{
+    int channels = 0;
+    const auto format = source.format();
+    switch (format)
+    {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        channels = 4;
+        break;
+    case QImage::Format_RGB888:
+        channels = 3;
+        break;
+    case QImage::Format_Grayscale8:
+        channels = 1;
+        break;
+    default: return source.scaled(newSize);
+    }
+
+    QImage result(newSize, format);
+
+    if (mode == FAST)
+    {
+        // One object per thread, so its buffers are reused between calls
+        thread_local avir::CLancIR lancir;
+        const avir::CLancIRParams params(int(source.bytesPerLine()), int(result.bytesPerLine()));
+        lancir.resizeImage(source.constBits(), source.width(), source.height(),
+            result.bits(), newSize.width(), newSize.height(), channels, &params);
+        return result;
+    }
+
+    const Detail::Job job = { source.constBits(), source.width(), source.height(), int(source.bytesPerLine()),
+                              result.bits(), newSize.width(), newSize.height(), int(result.bytesPerLine()),
+                              channels };
+
+    if (CpuFeatures::hasAvx() && Detail::resizeAvx(job))
+        return result;
+#ifdef EASYPAINT_AVIR_SSE
+    if (CpuFeatures::hasSse2())
+    {
+        static const avir::CImageResizer<avir::fpclass_float4> resizer(8);
+        runResizer(resizer, job);
+        return result;
+    }
+#endif
+    static const avir::CImageResizer<> resizer(8);
+    runResizer(resizer, job);
+    return result;
+}
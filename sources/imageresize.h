@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QImage>
+
+/**
+ * @brief Image resizing with AVIR (quality) or LANCIR (fast).
+ *
+ * For AVIR SSE or AVX code path is chosen by CPU features at run time and
+ * the work is spread over the global thread pool.
+ */
+namespace ImageResize
+{
+    enum Mode
+    {
+        QUALITY, /**< AVIR, for final results. */
+        FAST /**< LANCIR, for interactive use: previews, thumbnails. */
+    };
+
+    /**
+     * @brief Resize 32-bit, RGB888 or Grayscale8 image, other formats fall back to QImage::scaled.
+     */
+    QImage resize(const QImage &source, const QSize &newSize, Mode mode = QUALITY);
+}
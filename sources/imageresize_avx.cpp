@@ -0,0 +1,35 @@
+// Compiled with AVX enabled (see CMakeLists.txt), called only when CPU supports it.
+
+#include "imageresize_p.h"
+
+#ifdef __AVX__
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+// Keep all AVIR instances of this unit internal, see imageresize_p.h
+namespace {
+#include "avir/avir.h"
+#include "avir/avir_float8_avx.h"
+#include "imageresize_threadpool.h"
+}
+
+bool ImageResize::Detail::resizeAvx(const Job &job)
+{
+    static const avir::CImageResizer<avir::fpclass_float8_dil> resizer(8);
+    runResizer(resizer, job);
+    return true;
+}
+
+#else
+
+bool ImageResize::Detail::resizeAvx(const Job &)
+{
+    return false;
+}
+
+#endif // __AVX__
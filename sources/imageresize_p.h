@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Shared between imageresize.cpp and the AVX translation unit. Nothing here
+// may be inline or a template: the AVX unit is built with -mavx and the linker
+// could otherwise pick its copy for callers running on CPUs without AVX.
+namespace ImageResize
+{
+namespace Detail
+{
+    struct Job
+    {
+        const uchar *source;
+        int sourceWidth;
+        int sourceHeight;
+        int sourceBytesPerLine;
+        uchar *result;
+        int resultWidth;
+        int resultHeight;
+        int resultBytesPerLine;
+        int channels;
+    };
+
+    typedef void (*Task)(void *context, int index);
+
+    int suggestedThreadCount();
+    /**
+     * @brief Call task(context, i) for i in [0, count) on the global thread pool and wait.
+     */
+    void parallelFor(int count, void *context, Task task);
+
+    /**
+     * @brief Resize with AVX code path, false if it is not compiled in.
+     */
+    bool resizeAvx(const Job &job);
+}
+}
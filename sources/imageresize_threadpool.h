@@ -0,0 +1,51 @@
+// Included by imageresize translation units inside an unnamed namespace,
+// right after avir.h, so each of them gets its own copy of this class
+// built for its own instruction set. <vector> must be included before.
+
+/**
+ * @brief AVIR thread pool running workloads on the global QThreadPool.
+ */
+class AvirThreadPool : public avir::CImageResizerThreadPool
+{
+public:
+    int getSuggestedWorkloadCount() const override
+    {
+        return ImageResize::Detail::suggestedThreadCount();
+    }
+
+    void addWorkload(CWorkload *const workload) override
+    {
+        mWorkloads.push_back(workload);
+    }
+
+    void waitAllWorkloadsToFinish() override
+    {
+        ImageResize::Detail::parallelFor(int(mWorkloads.size()), this, &AvirThreadPool::process);
+    }
+
+    void removeAllWorkloads() override
+    {
+        mWorkloads.clear();
+    }
+
+private:
+    static void process(void *context, int index)
+    {
+        static_cast<AvirThreadPool*>(context)->mWorkloads[index]->process();
+    }
+
+    std::vector<CWorkload*> mWorkloads;
+};
+
+/**
+ * @brief Resize with the given AVIR resizer, using AvirThreadPool.
+ */
+template<typename Resizer>
+void runResizer(const Resizer &resizer, const ImageResize::Detail::Job &job)
+{
+    AvirThreadPool threadPool;
+    avir::CImageResizerVars vars;
+    vars.ThreadPool = &threadPool;
+    resizer.resizeImage(job.source, job.sourceWidth, job.sourceHeight, job.sourceBytesPerLine,
+        job.result, job.resultWidth, job.resultHeight, job.resultBytesPerLine, job.channels, 0, &vars);
+}
@@ -0,0 +1,57 @@
+#include "imagesaver.h"
+
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
+
+ImageSaver::ImageSaver(QObject *parent) :
+    QObject(parent)
+{
+    connect(&mWatcher, SIGNAL(finished()), this, SLOT(encodingFinished()));
+}
+
+void ImageSaver::save(const QImage &image, const QString &filePath, const QByteArray &format)
+{
+    Q_ASSERT(!mIsBusy);
+    mIsBusy = true;
+    mWatcher.setFuture(QtConcurrent::run(&ImageSaver::encode, image, filePath, format));
+}
+
+bool ImageSaver::waitForFinished()
+{
+    if (mIsBusy)
+    {
+        QEventLoop loop;
+        connect(this, SIGNAL(finished(bool)), &loop, SLOT(quit()));
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+    return mIsSuccess;
+}
+
+void ImageSaver::encodingFinished()
+{
+    mErrorString = mWatcher.result();
+    mIsSuccess = mErrorString.isEmpty();
+    mIsBusy = false;
+    emit finished(mIsSuccess);
+}
+
+QString ImageSaver::encode(const QImage &image, const QString &filePath, const QByteArray &format)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return file.errorString();
+
+    // Same format lookup as QImage::save() without explicit format
+    QImageWriter writer(&file, format.isEmpty() ? QFileInfo(filePath).suffix().toLatin1() : format);
+    if (!writer.write(image))
+    {
+        file.cancelWriting();
+        return writer.errorString();
+    }
+    if (!file.commit())
+        return file.errorString();
+    return QString();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief Encodes image to file on a thread pool worker.
+ *
+ * The image is taken as implicitly shared snapshot, so the canvas may be
+ * painted on while encoding runs. Data goes to a temporary file which replaces
+ * the target only once it is completely written.
+ */
+class ImageSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageSaver(QObject *parent = nullptr);
+
+    /**
+     * @brief Start saving, must not be called while previous save is running.
+     *
+     * @param format Image format, deduced from file suffix if empty.
+     */
+    void save(const QImage &image, const QString &filePath, const QByteArray &format = QByteArray());
+    /**
+     * @brief Process events except user input until current save is done.
+     *
+     * @return Whether the last save succeeded.
+     */
+    bool waitForFinished();
+
+    bool isBusy() const { return mIsBusy; }
+    QString getErrorString() const { return mErrorString; }
+
+signals:
+    void finished(bool isSuccess);
+
+private slots:
+    void encodingFinished();
+
+private:
+    static QString encode(const QImage &image, const QString &filePath, const QByteArray &format);
+
+    QFutureWatcher<QString> mWatcher; /**< Result is error string, empty on success. */
+    bool mIsBusy = false;
+    bool mIsSuccess = false;
+    QString mErrorString;
+};
@@ -0,0 +1,181 @@
+#include "imagetiledelta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool lessPos(const QPoint &a, const QPoint &b)
+{
+    return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+}
+
+bool isAreaEqual(const QImage &a, const QImage &b, const QRect &rect)
+{
+    const int bytesPerPixel = a.depth() / 8;
+    const size_t rowBytes = size_t(rect.width()) * bytesPerPixel;
+    const size_t offset = size_t(rect.x()) * bytesPerPixel;
+    for (int y = rect.top(); y <= rect.bottom(); ++y)
+    {
+        if (memcmp(a.constScanLine(y) + offset, b.constScanLine(y) + offset, rowBytes) != 0)
+            return false;
+    }
+    return true;
+}
+
+bool isTileEqual(const QImage &tile, const QImage &image, const QPoint &pos)
+{
+    const int bytesPerPixel = image.depth() / 8;
+    const size_t rowBytes = size_t(tile.width()) * bytesPerPixel;
+    const size_t offset = size_t(pos.x()) * bytesPerPixel;
+    for (int y = 0; y < tile.height(); ++y)
+    {
+        if (memcmp(tile.constScanLine(y), image.constScanLine(pos.y() + y) + offset, rowBytes) != 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool ImageTileDelta::isSupported(const QImage &image)
+{
+    return !image.isNull() && image.depth() % 8 == 0;
+}
+
+void ImageTileDelta::build(const QImage &before, const QImage &after, const ImageTileDelta *previous)
+{
+    mTiles.clear();
+    if (before.constBits() == after.constBits())
+        return;
+
+    const QRect imageRect = before.rect();
+    for (int y = 0; y < imageRect.height(); y += TILE_SIZE)
+    {
+        for (int x = 0; x < imageRect.width(); x += TILE_SIZE)
+        {
+            const QRect rect = QRect(x, y, TILE_SIZE, TILE_SIZE).intersected(imageRect);
+            if (isAreaEqual(before, after, rect))
+                continue;
+
+            Tile tile;
+            tile.pos = rect.topLeft();
+            tile.after = after.copy(rect);
+            tile.isBeforeShared = false;
+            if (previous)
+            {
+                const Tile *older = previous->findTile(tile.pos);
+                if (older && older->after.size() == rect.size()
+                        && isTileEqual(older->after, before, tile.pos))
+                {
+                    tile.before = older->after;
+                    tile.isBeforeShared = true;
+                }
+            }
+            if (!tile.isBeforeShared)
+                tile.before = before.copy(rect);
+            mTiles.append(tile);
+        }
+    }
+}
+
+void ImageTileDelta::applyBefore(QImage &image) const
+{
+    for (const Tile &tile : mTiles)
+        putTile(image, tile.pos, tile.before);
+}
+
+void ImageTileDelta::applyAfter(QImage &image) const
+{
+    for (const Tile &tile : mTiles)
+        putTile(image, tile.pos, tile.after);
+}
+
+qint64 ImageTileDelta::memoryUsage() const
+{
+    qint64 result = 0;
+    for (const Tile &tile : mTiles)
+    {
+        result += tile.after.sizeInBytes();
+        // Shared tile is counted by the older state, unless that one was dropped from history
+        if (!tile.isBeforeShared || tile.before.isDetached())
+            result += tile.before.sizeInBytes();
+    }
+    return result;
+}
+
+void ImageTileDelta::write(QDataStream &stream) const
+{
+    stream << qint32(mTiles.size());
+    for (const Tile &tile : mTiles)
+    {
+        stream << tile.pos;
+        writeImage(stream, tile.before);
+        writeImage(stream, tile.after);
+    }
+}
+
+void ImageTileDelta::read(QDataStream &stream)
+{
+    qint32 count = 0;
+    stream >> count;
+    mTiles.clear();
+    mTiles.reserve(count);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        Tile tile;
+        stream >> tile.pos;
+        tile.before = readImage(stream);
+        tile.after = readImage(stream);
+        tile.isBeforeShared = false;
+        mTiles.append(tile);
+    }
+}
+
+void ImageTileDelta::writeImage(QDataStream &stream, const QImage &image)
+{
+    stream << qint32(image.format()) << qint32(image.width()) << qint32(image.height());
+    if (image.isNull())
+        return;
+    stream << image.colorTable();
+    const int rowBytes = (image.width() * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y)
+        stream.writeRawData(reinterpret_cast<const char*>(image.constScanLine(y)), rowBytes);
+}
+
+QImage ImageTileDelta::readImage(QDataStream &stream)
+{
+    qint32 format = 0, width = 0, height = 0;
+    stream >> format >> width >> height;
+    if (format == QImage::Format_Invalid || width <= 0 || height <= 0)
+        return QImage();
+    QImage image(width, height, QImage::Format(format));
+    QVector<QRgb> colorTable;
+    stream >> colorTable;
+    if (!colorTable.isEmpty())
+        image.setColorTable(colorTable);
+    const int rowBytes = (image.width() * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y)
+        stream.readRawData(reinterpret_cast<char*>(image.scanLine(y)), rowBytes);
+    return image;
+}
+
+const ImageTileDelta::Tile *ImageTileDelta::findTile(const QPoint &pos) const
+{
+    auto it = std::lower_bound(mTiles.cbegin(), mTiles.cend(), pos,
+        [](const Tile &tile, const QPoint &p) { return lessPos(tile.pos, p); });
+    if (it != mTiles.cend() && it->pos == pos)
+        return &*it;
+    return nullptr;
+}
+
+void ImageTileDelta::putTile(QImage &image, const QPoint &pos, const QImage &tile)
+{
+    const int bytesPerPixel = image.depth() / 8;
+    const size_t rowBytes = size_t(tile.width()) * bytesPerPixel;
+    const size_t offset = size_t(pos.x()) * bytesPerPixel;
+    uchar *bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+    for (int y = 0; y < tile.height(); ++y)
+        memcpy(bits + (pos.y() + y) * bytesPerLine + offset, tile.constScanLine(y), rowBytes);
+}
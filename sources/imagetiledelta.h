@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QDataStream>
+#include <QImage>
+#include <QPoint>
+#include <QVector>
+
+/**
+ * @brief Tiles in which two equally sized images differ.
+ *
+ * The canvas is split into TILE_SIZE x TILE_SIZE squares; only the squares
+ * with changed pixels keep their "before" and "after" content.
+ */
+class ImageTileDelta
+{
+public:
+    enum { TILE_SIZE = 128 };
+
+    /**
+     * @brief Whether pixels of the image can be split into byte aligned tiles.
+     */
+    static bool isSupported(const QImage &image);
+
+    /**
+     * @brief Collect tiles which differ between before and after.
+     *
+     * @param previous Delta of the adjacent older state; its "after" tiles are
+     * shared instead of copied when they match our "before" tiles.
+     */
+    void build(const QImage &before, const QImage &after, const ImageTileDelta *previous = nullptr);
+
+    void applyBefore(QImage &image) const;
+    void applyAfter(QImage &image) const;
+
+    bool isEmpty() const { return mTiles.isEmpty(); }
+    void clear() { mTiles.clear(); }
+
+    /**
+     * @brief Bytes held by the tiles, not counting ones still shared with a live older state.
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * @brief Serialize tiles as raw pixels, used to move history out of memory.
+     */
+    void write(QDataStream &stream) const;
+    void read(QDataStream &stream);
+
+    static void writeImage(QDataStream &stream, const QImage &image);
+    static QImage readImage(QDataStream &stream);
+
+private:
+    struct Tile
+    {
+        QPoint pos;
+        QImage before;
+        QImage after;
+        bool isBeforeShared;
+    };
+
+    const Tile *findTile(const QPoint &pos) const;
+    static void putTile(QImage &image, const QPoint &pos, const QImage &tile);
+
+    QVector<Tile> mTiles; /**< Sorted by row, then by column. */
+};
@@ -26,6 +26,9 @@
 #include "abstractinstrument.h"
 #include "../imagearea.h"
 #include "../undocommand.h"
+#include "../datasingleton.h"
+
+#include <QPainter>
 
 AbstractInstrument::AbstractInstrument(QObject *parent) :
     QObject(parent)
@@ -48,3 +51,28 @@ void AbstractInstrument::applyStash(ImageArea& imageArea)
     imageArea.setImage(mImageCopy);
     imageArea.setMarkup(mMarkupCopy);
 }
+
+QImage AbstractInstrument::createPreview(const QRect &rect)
+{
+    QImage preview(rect.size(), QImage::Format_ARGB32_Premultiplied);
+    preview.fill(Qt::transparent);
+    return preview;
+}
+
+void AbstractInstrument::showPreview(ImageArea &imageArea, QImage &preview, const QRect &rect, bool isMarkup)
+{
+    if (isMarkup)
+    {
+        // markup is shown filled with the primary color, whatever was drawn into it
+        QPainter painter(&preview);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(preview.rect(), DataSingleton::Instance()->getPrimaryColor());
+    }
+    imageArea.setOverlay(preview, rect.topLeft());
+}
+
+QRect AbstractInstrument::strokeRect(const QRectF &shapeRect, int penSize)
+{
+    const int margin = penSize / 2 + 2;
+    return shapeRect.normalized().toAlignedRect().adjusted(-margin, -margin, margin, margin);
+}
@@ -69,6 +69,24 @@ protected:
     void stash(ImageArea& imageArea);
     void applyStash(ImageArea& imageArea);
 
+    /**
+     * @brief Bounding rectangle of a shape stroked with pen of given width.
+     *
+     * @param shapeRect Rectangle of the shape geometry, may be not normalized.
+     * @param penSize Pen width.
+     */
+    static QRect strokeRect(const QRectF &shapeRect, int penSize);
+    /**
+     * @brief Transparent image for a shape preview covering rect of the canvas.
+     */
+    static QImage createPreview(const QRect &rect);
+    /**
+     * @brief Shows preview drawn into createPreview() result on the overlay of the image area.
+     *
+     * @param isMarkup Preview is tinted the way markup is shown.
+     */
+    static void showPreview(ImageArea &imageArea, QImage &preview, const QRect &rect, bool isMarkup);
+
 private:
     QImage mImageCopy; /**< Image for storing copy of current image on imageArea, needed for some instruments. */
     QImage mMarkupCopy;
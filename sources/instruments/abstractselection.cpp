@@ -44,8 +44,8 @@ AbstractSelection::AbstractSelection(QObject *parent) :
 void AbstractSelection::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     const auto pos = event->pos();
-    const auto topLeftPoint = mTopLeftPoint * imageArea.getZoomFactor();
-    const auto bottomRightPoint = mBottomRightPoint * imageArea.getZoomFactor();
+    const auto topLeftPoint = imageArea.mapFromImage(mTopLeftPoint);
+    const auto bottomRightPoint = imageArea.mapFromImage(mBottomRightPoint);
 
     mButton = event->button();
     mIsMouseMoved = false;
@@ -80,13 +80,10 @@ void AbstractSelection::mousePressEvent(QMouseEvent *event, ImageArea &imageArea
                 drawBorder(imageArea);
             }
             mIsSelectionMoving = true;
-            mMoveDiffPoint = mBottomRightPoint - pos / imageArea.getZoomFactor();
+            mMoveDiffPoint = mBottomRightPoint - imageArea.mapToImage(pos);
             return;
         }
-        else if (pos.x() >= bottomRightPoint.x() &&
-            pos.x() <= bottomRightPoint.x() + 6 &&
-            pos.y() >= bottomRightPoint.y() &&
-            pos.y() <= bottomRightPoint.y() + 6)
+        else if (imageArea.getSelectionHandleRect().contains(pos))
         {
             if (!mIsSelectionAdjusting)
             {
@@ -105,7 +102,7 @@ void AbstractSelection::mousePressEvent(QMouseEvent *event, ImageArea &imageArea
     {
         mBottomRightPoint = mTopLeftPoint = clampPointToRect(
             { { 0, 0 }, imageArea.getImage()->size() },
-            event->pos() / imageArea.getZoomFactor());
+            imageArea.mapToImage(event->pos()));
         mHeight =  mWidth = 0;
         stash(imageArea);
         startSelection(imageArea);
@@ -116,7 +113,7 @@ void AbstractSelection::mousePressEvent(QMouseEvent *event, ImageArea &imageArea
 void AbstractSelection::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     const auto pos = clampPointToRect({ { 0, 0 }, imageArea.getImage()->size() },
-        event->pos() / imageArea.getZoomFactor());
+        imageArea.mapToImage(event->pos()));
 
     mIsMouseMoved = true;
     if (mIsSelectionExists)
@@ -126,7 +123,6 @@ void AbstractSelection::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
             mBottomRightPoint = pos + mMoveDiffPoint;
             mTopLeftPoint = pos + mMoveDiffPoint -
                                   QPoint(mWidth - 1, mHeight - 1);
-            applyStash(imageArea);
             move(imageArea);
             drawBorder(imageArea);
             mIsPaint = false;
@@ -136,7 +132,6 @@ void AbstractSelection::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
             mBottomRightPoint = pos;
             mHeight = fabs(mTopLeftPoint.y() - mBottomRightPoint.y()) + 1;
             mWidth = fabs(mTopLeftPoint.x() - mBottomRightPoint.x()) + 1;
-            applyStash(imageArea);
             resize(imageArea);
             drawBorder(imageArea);
             mIsPaint = false;
@@ -147,7 +142,6 @@ void AbstractSelection::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
         mBottomRightPoint = pos;
         mHeight = fabs(mTopLeftPoint.y() - mBottomRightPoint.y()) + 1;
         mWidth = fabs(mTopLeftPoint.x() - mBottomRightPoint.x()) + 1;
-        applyStash(imageArea);
         drawBorder(imageArea);
         select(imageArea);
     }
@@ -211,18 +205,13 @@ void AbstractSelection::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageAr
 
 void AbstractSelection::drawBorder(ImageArea &imageArea)
 {
-    if (mWidth > 1 && mHeight > 1)
+    if (mWidth > 1 && mHeight > 1 && mTopLeftPoint != mBottomRightPoint)
     {
-        QPainter painter(imageArea.getImage());
-        painter.setPen(QPen(Qt::blue, qMax(1, int(1 / imageArea.getZoomFactor())), Qt::DashLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBackgroundMode(Qt::TransparentMode);
-        if(mTopLeftPoint != mBottomRightPoint)
-        {
-            painter.drawRect(QRect(mTopLeftPoint, mBottomRightPoint - QPoint(1, 1)));
-        }
-        imageArea.setEdited(true);
-        painter.end();
-        imageArea.update();
+        imageArea.setSelectionChrome(QRect(mTopLeftPoint, mBottomRightPoint).normalized());
+    }
+    else
+    {
+        imageArea.clearSelectionChrome();
     }
 }
 
@@ -233,6 +222,8 @@ void AbstractSelection::clearSelection(ImageArea &imageArea)
         applyStash(imageArea);
         paint(imageArea);
         stash(imageArea);
+        imageArea.clearSelectionChrome();
+        imageArea.clearOverlay();
         mIsSelectionExists = mIsSelectionMoving = mIsSelectionResizing
                 = mIsPaint = mIsImageSelected = false;
         imageArea.update(); 
@@ -248,8 +239,8 @@ void AbstractSelection::saveImageChanges(ImageArea &)
 void AbstractSelection::updateCursor(QMouseEvent *event, ImageArea &imageArea)
 {
     const auto pos = event->pos();
-    const auto topLeftPoint = mTopLeftPoint * imageArea.getZoomFactor();
-    const auto bottomRightPoint = mBottomRightPoint * imageArea.getZoomFactor();
+    const auto topLeftPoint = imageArea.mapFromImage(mTopLeftPoint);
+    const auto bottomRightPoint = imageArea.mapFromImage(mBottomRightPoint);
 
     if (mIsSelectionExists)
     {
@@ -260,10 +251,7 @@ void AbstractSelection::updateCursor(QMouseEvent *event, ImageArea &imageArea)
         { 
             imageArea.setCursor(Qt::SizeAllCursor);
         }
-        else if (pos.x() >= bottomRightPoint.x() &&
-            pos.x() <= bottomRightPoint.x() + 6 &&
-            pos.y() >= bottomRightPoint.y() &&
-            pos.y() <= bottomRightPoint.y() + 6)
+        else if (imageArea.getSelectionHandleRect().contains(pos))
         {
             imageArea.setCursor(Qt::SizeFDiagCursor);
         }
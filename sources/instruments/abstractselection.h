@@ -70,6 +70,10 @@ public:
     virtual void showMenu(ImageArea &imageArea) = 0;
 
 protected:
+    /**
+     * @brief Shows selection chrome of the image area at the current selection.
+     *
+     */
     void drawBorder(ImageArea &imageArea);
     void updateCursor(QMouseEvent *event, ImageArea &imageArea);
 
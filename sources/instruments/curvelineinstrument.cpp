@@ -52,22 +52,29 @@ void CurveLineInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageAr
         //draw linear Bezier curve
         case 0:
             stash(imageArea);
-            mStartPoint = mEndPoint = mFirstControlPoint = mSecondControlPoint = event->pos() / imageArea.getZoomFactor();
+            mStartPoint = mEndPoint = mFirstControlPoint = mSecondControlPoint = imageArea.mapToImage(event->pos());
             ++mPointsCount;
             break;
         //draw square Bezier curve
         case 1:
-            mFirstControlPoint = mSecondControlPoint = event->pos() / imageArea.getZoomFactor();
+            mFirstControlPoint = mSecondControlPoint = imageArea.mapToImage(event->pos());
             ++mPointsCount;
             break;
         //draw cubic Bezier curve
         case 2:
-            mSecondControlPoint = event->pos() / imageArea.getZoomFactor();
+            mSecondControlPoint = imageArea.mapToImage(event->pos());
             mPointsCount = 0;
             break;
         }
         imageArea.setIsPaint(true);
         makeUndoCommand(imageArea);
+        if(mPointsCount != 1)
+        {
+            // the curve committed by the previous click is reshaped on the overlay
+            applyStash(imageArea);
+            imageArea.update();
+            paint(imageArea, event->button() == Qt::RightButton, true);
+        }
     }
 }
 
@@ -79,23 +86,22 @@ void CurveLineInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageAre
         {
         //draw linear Bezier curve
         case 1:
-            mEndPoint = event->pos() / imageArea.getZoomFactor();
+            mEndPoint = imageArea.mapToImage(event->pos());
             break;
         //draw square Bezier curve
         case 2:
-            mFirstControlPoint = mSecondControlPoint = event->pos() / imageArea.getZoomFactor();
+            mFirstControlPoint = mSecondControlPoint = imageArea.mapToImage(event->pos());
             break;
         //draw cubic Bezier curve
         case 0:
-            mSecondControlPoint = event->pos() / imageArea.getZoomFactor();
+            mSecondControlPoint = imageArea.mapToImage(event->pos());
             break;
         }
 
-        applyStash(imageArea);
         if(event->buttons() & Qt::LeftButton)
-            paint(imageArea, false);
+            paint(imageArea, false, true);
         else if(event->buttons() & Qt::RightButton)
-            paint(imageArea, true);
+            paint(imageArea, true, true);
     }
 }
 
@@ -103,7 +109,7 @@ void CurveLineInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &image
 {
     if(imageArea.isPaint())
     {
-        applyStash(imageArea);
+        imageArea.clearOverlay();
         if(event->button() == Qt::LeftButton)
             paint(imageArea, false);
         else if(event->button() == Qt::RightButton)
@@ -112,15 +118,24 @@ void CurveLineInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &image
     }
 }
 
-void CurveLineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
+void CurveLineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool isPreview)
 {
     const bool isMarkup = imageArea.isMarkupMode() && !isSecondaryColor;
 
-    QPainter painter(isMarkup ? imageArea.getMarkup() : imageArea.getImage());
     //make Bezier curve path
     QPainterPath path;
     path.moveTo(mStartPoint);
     path.cubicTo(mFirstControlPoint, mSecondControlPoint, mEndPoint);
+    const QRect rect = strokeRect(path.controlPointRect(),
+                                  DataSingleton::Instance()->getPenSize());
+
+    // Previews go to the overlay, the image is painted only on commit
+    QImage preview;
+    if (isPreview)
+        preview = createPreview(rect);
+    QPainter painter(isPreview ? &preview : (isMarkup ? imageArea.getMarkup() : imageArea.getImage()));
+    if (isPreview)
+        painter.translate(-rect.topLeft());
     //choose color
     painter.setPen(QPen(isSecondaryColor ? DataSingleton::Instance()->getSecondaryColor() :
         (isMarkup ? Qt::black : DataSingleton::Instance()->getPrimaryColor()),
@@ -129,7 +144,16 @@ void CurveLineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, boo
     //draw Bezier curve with given path
     painter.strokePath(path, painter.pen());
 
-    imageArea.setEdited(true);
     painter.end();
-    imageArea.update();
+    if (isPreview)
+    {
+        showPreview(imageArea, preview, rect, isMarkup);
+        return;
+    }
+    imageArea.setEdited(true);
+    if (isMarkup)
+    {
+        imageArea.updateMarkupRegion(rect);
+    }
+    imageArea.updateImageRect(rect);
 }
@@ -42,7 +42,7 @@ public:
     virtual void mouseReleaseEvent(QMouseEvent *event, ImageArea &imageArea);
 
 protected:
-    void paint(ImageArea &imageArea, bool isSecondaryColor = false, bool additionalFlag = false);
+    void paint(ImageArea &imageArea, bool isSecondaryColor = false, bool isPreview = false);
 
 private:
     QPoint mFirstControlPoint, mSecondControlPoint;
@@ -46,7 +46,7 @@ public:
     void mouseReleaseEvent(QMouseEvent *event, ImageArea &imageArea);
 
 protected:
-    void paint(ImageArea &imageArea, bool isSecondaryColor = false, bool additionalFlag = false);
+    void paint(ImageArea &imageArea, bool isSecondaryColor = false, bool isPreview = false);
     
 };
 
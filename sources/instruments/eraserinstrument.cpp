@@ -39,7 +39,7 @@ void EraserInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
         makeUndoCommand(imageArea);
     }
@@ -49,7 +49,7 @@ void EraserInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(imageArea.isPaint())
     {
-        const auto pos = event->pos() / imageArea.getZoomFactor();
+        const auto pos = imageArea.mapToImage(event->pos());
         mEndPoint = pos;
         paint(imageArea, false);
         mStartPoint = pos;
@@ -60,7 +60,7 @@ void EraserInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageAre
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mEndPoint = imageArea.mapToImage(event->pos());
         paint(imageArea);
         imageArea.setIsPaint(false);
     }
@@ -83,11 +83,7 @@ void EraserInstrument::paint(ImageArea &imageArea, bool, bool)
         painter.drawPoint(mStartPoint);
     }
     imageArea.setEdited(true);
-    //    int rad(DataSingleton::Instance()->getPenSize() + round(sqrt((mStartPoint.x() - mEndPoint.x()) *
-    //                                                                 (mStartPoint.x() - mEndPoint.x()) +
-    //                                                                 (mStartPoint.y() - mEndPoint.y()) *
-    //                                                                 (mStartPoint.y() - mEndPoint.y()))));
-    //    mPImageArea->update(QRect(mStartPoint, mEndPoint).normalized().adjusted(-rad, -rad, +rad, +rad));
     painter.end();
-    imageArea.update();
+    imageArea.updateImageRect(strokeRect(QRectF(mStartPoint, mEndPoint),
+                                         DataSingleton::Instance()->getPenSize()));
 }
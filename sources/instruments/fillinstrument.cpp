@@ -24,12 +24,10 @@
  */
 
 #include "fillinstrument.h"
+#include "floodfill.h"
 #include "../imagearea.h"
 #include "../datasingleton.h"
 
-#include <QPen>
-#include <QPainter>
-
 FillInstrument::FillInstrument(QObject *parent) :
     AbstractInstrument(parent)
 {
@@ -39,7 +37,7 @@ void FillInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
         makeUndoCommand(imageArea);
     }
@@ -68,69 +66,27 @@ void FillInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageArea)
 
 void FillInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
 {
-    QColor switchColor;
-    if(!isSecondaryColor)
-        switchColor = DataSingleton::Instance()->getPrimaryColor();
-    else
-        switchColor = DataSingleton::Instance()->getSecondaryColor();
-
-    QRgb pixel(imageArea.getImage()->pixel(mStartPoint));
-    QColor oldColor(pixel);
+    const bool isMarkup = imageArea.isMarkupMode() && !isSecondaryColor;
+    const int tolerance = DataSingleton::Instance()->getFillTolerance();
+    const bool isEightConnected = DataSingleton::Instance()->getIsFillEightConnected();
 
-    if(switchColor != oldColor)
+    QRect rect;
+    if (isMarkup)
     {
-        fillRecurs(mStartPoint.x(), mStartPoint.y(),
-                   switchColor.rgb(), oldColor.rgb(),
-                   *imageArea.getImage());
+        // Area is taken from the image, so markup can outline its objects
+        rect = floodFillMask(*imageArea.getImage(), mStartPoint, *imageArea.getMarkup(), 0,
+                             tolerance, isEightConnected);
+        if (rect.isValid())
+            imageArea.updateMarkupRegion(rect);
     }
-    imageArea.setEdited(true);
-    imageArea.update();
-}
-
-void FillInstrument::fillRecurs(int x, int y, QRgb switchColor, QRgb oldColor, QImage &tempImage)
-{
-    int temp_x(x), left_x(0);
-    while(true)
-    {
-        if(tempImage.pixel(temp_x, y) != oldColor)
-            break;
-        tempImage.setPixel(temp_x, y, switchColor);
-        if(temp_x > 0)
-        {
-            --temp_x;
-            left_x = temp_x;
-        }
-        else
-            break;
-    }
-
-    int right_x(0);
-    temp_x = x + 1;
-    while(true)
-    {
-        if(tempImage.pixel(temp_x, y) != oldColor)
-            break;
-        tempImage.setPixel(temp_x, y, switchColor);
-        if(temp_x < tempImage.width() - 1)
-        {
-            temp_x++;
-            right_x = temp_x;
-        }
-        else
-            break;
-    }
-
-    for(int x_(left_x+1); x_ < right_x; ++x_)
+    else
     {
-        if(y < 1 || y >= tempImage.height() - 1)
-            break;
-        if(right_x > tempImage.width())
-            break;
-        QRgb currentColor = tempImage.pixel(x_, y - 1);
-        if(currentColor == oldColor && currentColor != switchColor)
-            fillRecurs(x_, y - 1, switchColor, oldColor, tempImage);
-        currentColor = tempImage.pixel(x_, y + 1);
-        if(currentColor == oldColor && currentColor != switchColor)
-            fillRecurs(x_, y + 1, switchColor, oldColor, tempImage);
+        const QColor switchColor = isSecondaryColor ? DataSingleton::Instance()->getSecondaryColor()
+                                                    : DataSingleton::Instance()->getPrimaryColor();
+        rect = floodFill(*imageArea.getImage(), mStartPoint, switchColor.rgba(),
+                         tolerance, isEightConnected);
     }
+    imageArea.setEdited(true);
+    if (rect.isValid())
+        imageArea.updateImageRect(rect);
 }
@@ -0,0 +1,63 @@
+/*
+ * This source file is part of EasyPaint.
+ *
+ * Copyright (c) 2012 EasyPaint <https://github.com/Gr1N/EasyPaint>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "floatingselection.h"
+#include "../imageresize.h"
+
+namespace {
+
+// Above this many pixels bilinear filtering can't keep up with the mouse
+const qint64 BILINEAR_PREVIEW_LIMIT = 2048 * 2048;
+
+} // namespace
+
+void FloatingSelection::setImage(const QImage &image)
+{
+    mImage = image;
+    mPreview = QImage();
+    mResampled = QImage();
+}
+
+const QImage &FloatingSelection::getPreview(const QSize &size)
+{
+    if (size == mImage.size())
+        return mImage;
+    if (mPreview.size() != size)
+    {
+        const bool isLarge = qint64(size.width()) * size.height() > BILINEAR_PREVIEW_LIMIT;
+        mPreview = mImage.scaled(size, Qt::IgnoreAspectRatio,
+                                 isLarge ? Qt::FastTransformation : Qt::SmoothTransformation);
+    }
+    return mPreview;
+}
+
+const QImage &FloatingSelection::getResampled(const QSize &size)
+{
+    if (size == mImage.size())
+        return mImage;
+    if (mResampled.size() != size)
+        mResampled = ImageResize::resize(mImage, size, ImageResize::QUALITY);
+    return mResampled;
+}
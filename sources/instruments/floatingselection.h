@@ -0,0 +1,60 @@
+/*
+ * This source file is part of EasyPaint.
+ *
+ * Copyright (c) 2012 EasyPaint <https://github.com/Gr1N/EasyPaint>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FLOATINGSELECTION_H
+#define FLOATINGSELECTION_H
+
+#include <QImage>
+
+/**
+ * @brief Pixels of a selection lifted off the canvas or pasted into it.
+ *
+ * Moves and scales are previewed with a cheap scaled copy; the canvas gets an
+ * AVIR resampled copy on commit. Both copies are cached for their last size.
+ */
+class FloatingSelection
+{
+public:
+    void setImage(const QImage &image);
+    const QImage &getImage() const { return mImage; }
+    bool isNull() const { return mImage.isNull(); }
+    void clear() { setImage(QImage()); }
+
+    /**
+     * @brief Nearest neighbour or bilinear copy of given size for interactive previews.
+     */
+    const QImage &getPreview(const QSize &size);
+    /**
+     * @brief High quality copy of given size to be painted into the canvas.
+     */
+    const QImage &getResampled(const QSize &size);
+
+private:
+    QImage mImage;
+    QImage mPreview;
+    QImage mResampled;
+};
+
+#endif // FLOATINGSELECTION_H
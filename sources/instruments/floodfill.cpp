@@ -0,0 +1,241 @@
+/*
+ * This source file is part of EasyPaint.
+ *
+ * Copyright (c) 2012 EasyPaint <https://github.com/Gr1N/EasyPaint>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "floodfill.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief One bit per pixel, set for pixels already filled.
+ *
+ * Keeps the fill finite when the new color itself matches the seed within tolerance.
+ */
+class VisitedMask
+{
+public:
+    VisitedMask(int width, int height)
+        : mStride((width + 63) / 64), mBits(size_t(mStride) * height, 0) {}
+
+    bool test(int x, int y) const
+    {
+        return (mBits[size_t(y) * mStride + (x >> 6)] >> (x & 63)) & 1;
+    }
+    void set(int x, int y)
+    {
+        mBits[size_t(y) * mStride + (x >> 6)] |= quint64(1) << (x & 63);
+    }
+
+private:
+    int mStride;
+    std::vector<quint64> mBits;
+};
+
+struct ExactMatch32
+{
+    quint32 seed;
+    bool operator()(quint32 pixel) const { return pixel == seed; }
+};
+
+struct ToleranceMatch32
+{
+    quint32 seed;
+    int tolerance;
+    bool operator()(quint32 pixel) const
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            if (std::abs(int((pixel >> shift) & 0xff) - int((seed >> shift) & 0xff)) > tolerance)
+                return false;
+        }
+        return true;
+    }
+};
+
+struct Match8
+{
+    int seed;
+    int tolerance;
+    bool operator()(uchar pixel) const { return std::abs(int(pixel) - seed) <= tolerance; }
+};
+
+/**
+ * @brief Find area connected to seed and pass its horizontal spans to write(y, left, right).
+ */
+template<typename Pixel, typename Match, typename Write>
+QRect scanFill(const QImage &source, const QPoint &seed, Match match, bool isEightConnected, Write write)
+{
+    const int width = source.width();
+    const int height = source.height();
+    const int diagonal = isEightConnected ? 1 : 0;
+    VisitedMask visited(width, height);
+    std::vector<QPoint> stack;
+    stack.push_back(seed);
+
+    int minX = width, minY = height, maxX = -1, maxY = -1;
+
+    while (!stack.empty())
+    {
+        const QPoint point = stack.back();
+        stack.pop_back();
+        const int y = point.y();
+        const Pixel *row = reinterpret_cast<const Pixel*>(source.constScanLine(y));
+        if (visited.test(point.x(), y) || !match(row[point.x()]))
+            continue;
+
+        int left = point.x();
+        while (left > 0 && !visited.test(left - 1, y) && match(row[left - 1]))
+            --left;
+        int right = point.x();
+        while (right < width - 1 && !visited.test(right + 1, y) && match(row[right + 1]))
+            ++right;
+
+        for (int x = left; x <= right; ++x)
+            visited.set(x, y);
+        write(y, left, right);
+
+        minX = std::min(minX, left);
+        maxX = std::max(maxX, right);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+
+        // One seed per run of matching pixels in the neighbouring rows
+        const int from = std::max(left - diagonal, 0);
+        const int to = std::min(right + diagonal, width - 1);
+        for (int ny = y - 1; ny <= y + 1; ny += 2)
+        {
+            if (ny < 0 || ny >= height)
+                continue;
+            const Pixel *nrow = reinterpret_cast<const Pixel*>(source.constScanLine(ny));
+            int x = from;
+            while (x <= to)
+            {
+                if (!visited.test(x, ny) && match(nrow[x]))
+                {
+                    stack.push_back(QPoint(x, ny));
+                    while (x <= to && !visited.test(x, ny) && match(nrow[x]))
+                        ++x;
+                }
+                else
+                {
+                    ++x;
+                }
+            }
+        }
+    }
+
+    if (maxX < 0)
+        return QRect();
+    return QRect(QPoint(minX, minY), QPoint(maxX, maxY));
+}
+
+bool is32Bit(QImage::Format format)
+{
+    return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32
+        || format == QImage::Format_ARGB32_Premultiplied;
+}
+
+/**
+ * @brief Run scanFill with matcher suitable for source format.
+ */
+template<typename Write>
+QRect scanFillAny(const QImage &source, const QPoint &seed, int tolerance, bool isEightConnected, Write write)
+{
+    if (source.format() == QImage::Format_Grayscale8)
+    {
+        const Match8 match = { source.constScanLine(seed.y())[seed.x()], tolerance };
+        return scanFill<uchar>(source, seed, match, isEightConnected, write);
+    }
+
+    const quint32 seedPixel = reinterpret_cast<const quint32*>(source.constScanLine(seed.y()))[seed.x()];
+    if (tolerance <= 0)
+        return scanFill<quint32>(source, seed, ExactMatch32{ seedPixel }, isEightConnected, write);
+    return scanFill<quint32>(source, seed, ToleranceMatch32{ seedPixel, tolerance }, isEightConnected, write);
+}
+
+} // namespace
+
+QRect floodFill(QImage &image, const QPoint &seed, QRgb color, int tolerance, bool isEightConnected)
+{
+    if (!image.rect().contains(seed))
+        return QRect();
+
+    const QImage::Format format = image.format();
+    if (!is32Bit(format) && format != QImage::Format_Grayscale8)
+    {
+        QImage temp = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const QRect rect = floodFill(temp, seed, color, tolerance, isEightConnected);
+        image = temp.convertToFormat(format);
+        return rect;
+    }
+
+    // Detach before taking row pointers, image is shared with undo history
+    uchar *bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+
+    if (format == QImage::Format_Grayscale8)
+    {
+        const uchar value = uchar(qGray(color));
+        return scanFillAny(image, seed, tolerance, isEightConnected, [=](int y, int left, int right) {
+            memset(bits + y * bytesPerLine + left, value, right - left + 1);
+        });
+    }
+
+    quint32 value = color;
+    if (format == QImage::Format_ARGB32_Premultiplied)
+        value = qPremultiply(color);
+    else if (format == QImage::Format_RGB32)
+        value = color | 0xff000000;
+    return scanFillAny(image, seed, tolerance, isEightConnected, [=](int y, int left, int right) {
+        quint32 *row = reinterpret_cast<quint32*>(bits + y * bytesPerLine);
+        std::fill(row + left, row + right + 1, value);
+    });
+}
+
+QRect floodFillMask(const QImage &source, const QPoint &seed, QImage &mask, uchar value,
+                    int tolerance, bool isEightConnected)
+{
+    if (!source.rect().contains(seed) || mask.size() != source.size()
+            || mask.format() != QImage::Format_Grayscale8)
+        return QRect();
+
+    QImage converted;
+    const QImage *image = &source;
+    if (!is32Bit(source.format()) && source.format() != QImage::Format_Grayscale8)
+    {
+        converted = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        image = &converted;
+    }
+
+    uchar *bits = mask.bits();
+    const qsizetype bytesPerLine = mask.bytesPerLine();
+    return scanFillAny(*image, seed, tolerance, isEightConnected, [=](int y, int left, int right) {
+        memset(bits + y * bytesPerLine + left, value, right - left + 1);
+    });
+}
@@ -0,0 +1,53 @@
+/*
+ * This source file is part of EasyPaint.
+ *
+ * Copyright (c) 2012 EasyPaint <https://github.com/Gr1N/EasyPaint>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FLOODFILL_H
+#define FLOODFILL_H
+
+#include <QImage>
+#include <QRect>
+
+/**
+ * @brief Fill connected area of similar color with the given color.
+ *
+ * Iterative scanline algorithm working directly on scan lines of 32-bit and
+ * Grayscale8 images; other formats are converted forth and back.
+ *
+ * @param tolerance Max difference of each channel from the seed pixel.
+ * @param isEightConnected Spread through diagonal neighbours too.
+ * @return Bounding rect of changed pixels.
+ */
+QRect floodFill(QImage &image, const QPoint &seed, QRgb color,
+                int tolerance = 0, bool isEightConnected = false);
+
+/**
+ * @brief Same as floodFill, but area found in source is written to mask.
+ *
+ * Used to fill markup layer (Grayscale8 of the same size) by image content.
+ */
+QRect floodFillMask(const QImage &source, const QPoint &seed, QImage &mask, uchar value,
+                    int tolerance = 0, bool isEightConnected = false);
+
+#endif // FLOODFILL_H
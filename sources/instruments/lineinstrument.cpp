@@ -40,9 +40,8 @@ void LineInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
-        stash(imageArea);
         makeUndoCommand(imageArea);
     }
 }
@@ -51,15 +50,14 @@ void LineInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
-        applyStash(imageArea);
+        mEndPoint = imageArea.mapToImage(event->pos());
         if(event->buttons() & Qt::LeftButton)
         {
-            paint(imageArea, false);
+            paint(imageArea, false, true);
         }
         else if(event->buttons() & Qt::RightButton)
         {
-            paint(imageArea, true);
+            paint(imageArea, true, true);
         }
     }
 }
@@ -68,7 +66,7 @@ void LineInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(imageArea.isPaint())
     {
-        applyStash(imageArea);
+        imageArea.clearOverlay();
         if(event->button() == Qt::LeftButton)
         {
             paint(imageArea, false);
@@ -81,11 +79,20 @@ void LineInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageArea)
     }
 }
 
-void LineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
+void LineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool isPreview)
 {
     const bool isMarkup = imageArea.isMarkupMode() && !isSecondaryColor;
 
-    QPainter painter(isMarkup ? imageArea.getMarkup() : imageArea.getImage());
+    const QRect rect = strokeRect(QRectF(mStartPoint, mEndPoint),
+                                  DataSingleton::Instance()->getPenSize());
+
+    // Previews go to the overlay, the image is painted only on commit
+    QImage preview;
+    if (isPreview)
+        preview = createPreview(rect);
+    QPainter painter(isPreview ? &preview : (isMarkup ? imageArea.getMarkup() : imageArea.getImage()));
+    if (isPreview)
+        painter.translate(-rect.topLeft());
     painter.setPen(QPen(isSecondaryColor ? DataSingleton::Instance()->getSecondaryColor() :
         (isMarkup ? Qt::black : DataSingleton::Instance()->getPrimaryColor()),
                         DataSingleton::Instance()->getPenSize(), // * imageArea.getZoomFactor(),
@@ -100,12 +107,16 @@ void LineInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
     {
         painter.drawPoint(mStartPoint);
     }
-    imageArea.setEdited(true);
-    //    int rad(DataSingleton::Instance()->getPenSize() + round(sqrt((mStartPoint.x() - mEndPoint.x()) *
-    //                                                                 (mStartPoint.x() - mEndPoint.x()) +
-    //                                                                 (mStartPoint.y() - mEndPoint.y()) *
-    //                                                                 (mStartPoint.y() - mEndPoint.y()))));
-    //    mPImageArea->update(QRect(mStartPoint, mEndPoint).normalized().adjusted(-rad, -rad, +rad, +rad));
     painter.end();
-    imageArea.update();
+    if (isPreview)
+    {
+        showPreview(imageArea, preview, rect, isMarkup);
+        return;
+    }
+    imageArea.setEdited(true);
+    if (isMarkup)
+    {
+        imageArea.updateMarkupRegion(rect);
+    }
+    imageArea.updateImageRect(rect);
 }
@@ -50,11 +50,11 @@ void MagnifierInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &image
     {
         if(event->button() == Qt::LeftButton)
         {
-            imageArea.setZoomFactor(2.0);
+            imageArea.setZoomFactor(2.0, event->pos());
         }
         else if(event->button() == Qt::RightButton)
         {
-            imageArea.setZoomFactor(0.5);
+            imageArea.setZoomFactor(0.5, event->pos());
         }
         imageArea.setIsPaint(false);
     }
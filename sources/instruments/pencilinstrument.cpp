@@ -39,7 +39,7 @@ void PencilInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
         makeUndoCommand(imageArea);
     }
@@ -49,7 +49,7 @@ void PencilInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mEndPoint = imageArea.mapToImage(event->pos());
         if(event->buttons() & Qt::LeftButton)
         {
             paint(imageArea, false);
@@ -58,7 +58,7 @@ void PencilInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
         {
             paint(imageArea, true);
         }
-        mStartPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = imageArea.mapToImage(event->pos());
     }
 }
 
@@ -66,7 +66,7 @@ void PencilInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &imageAre
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mEndPoint = imageArea.mapToImage(event->pos());
         if(event->button() == Qt::LeftButton)
         {
             paint(imageArea, false);
@@ -99,11 +99,12 @@ void PencilInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
         painter.drawPoint(mStartPoint);
     }
     imageArea.setEdited(true);
-    //    int rad(DataSingleton::Instance()->getPenSize() + round(sqrt((mStartPoint.x() - mEndPoint.x()) *
-    //                                                                 (mStartPoint.x() - mEndPoint.x()) +
-    //                                                                 (mStartPoint.y() - mEndPoint.y()) *
-    //                                                                 (mStartPoint.y() - mEndPoint.y()))));
-    //    mPImageArea->update(QRect(mStartPoint, mEndPoint).normalized().adjusted(-rad, -rad, +rad, +rad));
     painter.end();
-    imageArea.update();
+    const QRect rect = strokeRect(QRectF(mStartPoint, mEndPoint),
+                                  DataSingleton::Instance()->getPenSize());
+    if (isMarkup)
+    {
+        imageArea.updateMarkupRegion(rect);
+    }
+    imageArea.updateImageRect(rect);
 }
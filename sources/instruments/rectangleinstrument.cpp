@@ -39,9 +39,8 @@ void RectangleInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageAr
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
-        stash(imageArea);
         makeUndoCommand(imageArea);
     }
 }
@@ -50,15 +49,14 @@ void RectangleInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageAre
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
-        applyStash(imageArea);
+        mEndPoint = imageArea.mapToImage(event->pos());
         if(event->buttons() & Qt::LeftButton)
         {
-            paint(imageArea, false);
+            paint(imageArea, false, true);
         }
         else if(event->buttons() & Qt::RightButton)
         {
-            paint(imageArea, true);
+            paint(imageArea, true, true);
         }
     }
 }
@@ -67,7 +65,7 @@ void RectangleInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &image
 {
     if(imageArea.isPaint())
     {
-        applyStash(imageArea);
+        imageArea.clearOverlay();
         if(event->button() == Qt::LeftButton)
         {
             paint(imageArea, false);
@@ -80,11 +78,20 @@ void RectangleInstrument::mouseReleaseEvent(QMouseEvent *event, ImageArea &image
     }
 }
 
-void RectangleInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
+void RectangleInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool isPreview)
 {
     const bool isMarkup = imageArea.isMarkupMode() && !isSecondaryColor;
 
-    QPainter painter(isMarkup ? imageArea.getMarkup() : imageArea.getImage());
+    const QRect rect = strokeRect(QRectF(mStartPoint, mEndPoint),
+                                  DataSingleton::Instance()->getPenSize());
+
+    // Previews go to the overlay, the image is painted only on commit
+    QImage preview;
+    if (isPreview)
+        preview = createPreview(rect);
+    QPainter painter(isPreview ? &preview : (isMarkup ? imageArea.getMarkup() : imageArea.getImage()));
+    if (isPreview)
+        painter.translate(-rect.topLeft());
     painter.setPen(QPen(isMarkup ? Qt::black : DataSingleton::Instance()->getPrimaryColor(),
                         DataSingleton::Instance()->getPenSize(), // * imageArea.getZoomFactor(),
                         Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
@@ -96,12 +103,16 @@ void RectangleInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, boo
     {
         painter.drawRect(QRectF(mStartPoint, mEndPoint));
     }
-    imageArea.setEdited(true);
-//    int rad(DataSingleton::Instance()->getPenSize() + round(sqrt((mStartPoint.x() - mEndPoint.x()) *
-//                                                                 (mStartPoint.x() - mEndPoint.x()) +
-//                                                                 (mStartPoint.y() - mEndPoint.y()) *
-//                                                                 (mStartPoint.y() - mEndPoint.y()))));
-//    mPImageArea->update(QRect(mStartPoint, mEndPoint).normalized().adjusted(-rad, -rad, +rad, +rad));
     painter.end();
-    imageArea.update();
+    if (isPreview)
+    {
+        showPreview(imageArea, preview, rect, isMarkup);
+        return;
+    }
+    imageArea.setEdited(true);
+    if (isMarkup)
+    {
+        imageArea.updateMarkupRegion(rect);
+    }
+    imageArea.updateImageRect(rect);
 }
@@ -46,7 +46,7 @@ void SelectionInstrument::copyImage(ImageArea &imageArea)
         QImage copyImage;
         if(mIsImageSelected)
         {
-            copyImage = mSelectedImage;
+            copyImage = mSelected.getImage();
         }
         else
         {
@@ -78,6 +78,7 @@ void SelectionInstrument::cutImage(ImageArea &imageArea)
         mTopLeftPoint = QPoint(0, 0);
         mBottomRightPoint = QPoint(0, 0);
         stash(imageArea);
+        imageArea.clearSelectionChrome();
         imageArea.update();
         mIsSelectionExists = false;
         imageArea.restoreCursor();
@@ -100,7 +101,7 @@ void SelectionInstrument::pasteImage(ImageArea &imageArea)
     {
         imageArea.resizeCanvas(qMax(pasteImage.width(), imageArea.getImage()->width()),
             qMax(pasteImage.height(), imageArea.getImage()->height()));
-        mSelectedImage = pasteImage;
+        mSelected.setImage(pasteImage);
         stash(imageArea);
         mTopLeftPoint = QPoint(0, 0);
         mBottomRightPoint = QPoint(pasteImage.width(), pasteImage.height()) - QPoint(1, 1);
@@ -149,12 +150,29 @@ void SelectionInstrument::select(ImageArea &)
 {
 }
 
-void SelectionInstrument::resize(ImageArea &)
+void SelectionInstrument::resize(ImageArea &imageArea)
 {
+    showFloating(imageArea);
 }
 
-void SelectionInstrument::move(ImageArea &)
+void SelectionInstrument::move(ImageArea &imageArea)
 {
+    showFloating(imageArea);
+}
+
+void SelectionInstrument::showFloating(ImageArea &imageArea)
+{
+    if (mIsSelectionAdjusting || mSelected.isNull())
+        return;
+    if (!mIsFloatingShown)
+    {
+        // The press painted the selection back into the image, lift it off again
+        applyStash(imageArea);
+        imageArea.update();
+        mIsFloatingShown = true;
+    }
+    const QRect target = QRect(mTopLeftPoint, mBottomRightPoint).normalized();
+    imageArea.setOverlay(mSelected.getPreview(target.size()), target.topLeft());
 }
 
 void SelectionInstrument::completeSelection(ImageArea &imageArea)
@@ -165,11 +183,15 @@ void SelectionInstrument::completeSelection(ImageArea &imageArea)
 
 void SelectionInstrument::completeResizing(ImageArea &imageArea)
 {
+    imageArea.clearOverlay();
+    mIsFloatingShown = false;
     doCopy(imageArea);
 }
 
 void SelectionInstrument::completeMoving(ImageArea &imageArea)
 {
+    imageArea.clearOverlay();
+    mIsFloatingShown = false;
     if (mIsSelectionAdjusting)
     {
         doCopy(imageArea);
@@ -186,13 +208,15 @@ void SelectionInstrument::clearSelectionBackground(ImageArea &imageArea)
         blankPainter.setBackgroundMode(Qt::OpaqueMode);
         blankPainter.drawRect(QRect(mTopLeftPoint, mBottomRightPoint - QPoint(1, 1)));
         blankPainter.end();
+        imageArea.updateImageRect(QRect(mTopLeftPoint, mBottomRightPoint).normalized());
         stash(imageArea);
     }
 }
 
 void SelectionInstrument::clear()
 {
-    mSelectedImage = QImage();
+    mSelected.clear();
+    mIsFloatingShown = false;
     emit sendEnableCopyCutActions(false);
 }
 
@@ -200,16 +224,16 @@ void SelectionInstrument::paint(ImageArea &imageArea, bool, bool)
 {
     if (mIsSelectionExists && !mIsSelectionAdjusting)
     {
+        const QRect target = QRect(mTopLeftPoint, mBottomRightPoint).normalized();
         if(mTopLeftPoint != mBottomRightPoint)
         {
+            // Unscaled blit of the target rect, resampled once per size
             QPainter painter(imageArea.getImage());
-            QRect source(0, 0, mSelectedImage.width(), mSelectedImage.height());
-            QRect target(mTopLeftPoint, mBottomRightPoint);
-            painter.drawImage(target, mSelectedImage, source);
+            painter.drawImage(target.topLeft(), mSelected.getResampled(target.size()));
             painter.end();
         }
         imageArea.setEdited(true);
-        imageArea.update();
+        imageArea.updateImageRect(target);
     }
 }
 
@@ -220,7 +244,7 @@ void SelectionInstrument::showMenu(ImageArea &)
 void SelectionInstrument::doCopy(ImageArea& imageArea)
 {
     QImage* src = imageArea.getImage();
-    mSelectedImage = src->copy(mTopLeftPoint.x(),
+    mSelected.setImage(src->copy(mTopLeftPoint.x(),
         mTopLeftPoint.y(),
-        mWidth, mHeight);
+        mWidth, mHeight));
 }
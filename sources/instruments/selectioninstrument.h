@@ -27,6 +27,7 @@
 #define SELECTIONINSTRUMENT_H
 
 #include "abstractselection.h"
+#include "floatingselection.h"
 
 QT_BEGIN_NAMESPACE
 class QUndoStack;
@@ -70,8 +71,8 @@ private:
     void startResizing(ImageArea &imageArea);
     void startMoving(ImageArea &imageArea);
     void select(ImageArea &);
-    void resize(ImageArea &);
-    void move(ImageArea &);
+    void resize(ImageArea &imageArea);
+    void move(ImageArea &imageArea);
     void completeSelection(ImageArea &imageArea);
     void completeResizing(ImageArea &imageArea);
     void completeMoving(ImageArea &imageArea);
@@ -79,8 +80,14 @@ private:
     void paint(ImageArea &imageArea, bool = false, bool = false);
     void showMenu(ImageArea &);
     void doCopy(ImageArea& imageArea);
+    /**
+     * @brief Shows floating pixels at the current selection on the overlay of image area.
+     *
+     */
+    void showFloating(ImageArea &imageArea);
 
-    QImage mSelectedImage; /**< Copy of selected image. */
+    FloatingSelection mSelected; /**< Copy of selected image. */
+    bool mIsFloatingShown = false; /**< Floating pixels are on the overlay, not in the image. */
 
 signals:
     void sendEnableCopyCutActions(bool enable);
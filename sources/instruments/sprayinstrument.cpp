@@ -30,6 +30,7 @@
 #include <QPen>
 #include <QPainter>
 #include <math.h>
+#include <QtMath>
 
 #include <QRandomGenerator>
 
@@ -42,7 +43,7 @@ void SprayInstrument::mousePressEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(event->button() == Qt::LeftButton || event->button() == Qt::RightButton)
     {
-        mStartPoint = mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = mEndPoint = imageArea.mapToImage(event->pos());
         imageArea.setIsPaint(true);
         makeUndoCommand(imageArea);
     }
@@ -52,7 +53,7 @@ void SprayInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
 {
     if(imageArea.isPaint())
     {
-        mEndPoint = event->pos() / imageArea.getZoomFactor();
+        mEndPoint = imageArea.mapToImage(event->pos());
         if(event->buttons() & Qt::LeftButton)
         {
             paint(imageArea, false);
@@ -61,7 +62,7 @@ void SprayInstrument::mouseMoveEvent(QMouseEvent *event, ImageArea &imageArea)
         {
             paint(imageArea, true);
         }
-        mStartPoint = event->pos() / imageArea.getZoomFactor();
+        mStartPoint = imageArea.mapToImage(event->pos());
     }
 }
 
@@ -114,5 +115,7 @@ void SprayInstrument::paint(ImageArea &imageArea, bool isSecondaryColor, bool)
 
     imageArea.setEdited(true);
     painter.end();
-    imageArea.update();
+    const int spread = qCeil(7 * scale);
+    imageArea.updateImageRect(strokeRect(QRectF(mEndPoint, mEndPoint).adjusted(-spread, -spread, spread, spread),
+                                         qCeil(scale)));
 }
@@ -73,11 +73,13 @@ void TextInstrument::select(ImageArea &)
 
 void TextInstrument::resize(ImageArea &imageArea)
 {
+    applyStash(imageArea);
     paint(imageArea);
 }
 
 void TextInstrument::move(ImageArea &imageArea)
 {
+    applyStash(imageArea);
     paint(imageArea);
 }
 
@@ -122,7 +124,7 @@ void TextInstrument::paint(ImageArea &imageArea, bool, bool)
         painter.drawText(QRect(mTopLeftPoint, mBottomRightPoint), mText);
         painter.end();
         imageArea.setEdited(true);
-        imageArea.update();
+        imageArea.updateImageRect(QRect(mTopLeftPoint, mBottomRightPoint).normalized());
     }
 }
 
@@ -27,6 +27,7 @@
 #include "datasingleton.h"
 #include "set_dark_theme.h"
 #include "ScriptModel.h"
+#include "scriptworker.h"
 
 #include "qtsingleapplication/qtsingleapplication.h"
 
@@ -170,6 +171,12 @@ int main(int argc, char* argv[])
     QApplication::setApplicationVersion(EASYPAINT_VERSION);
 
     QStringList args = a.arguments();
+    // Worker processes take the rest of the command line, see ScriptWorkerPool
+    if (args.size() > 1 && args.at(1) == SCRIPT_WORKER_OPTION)
+    {
+        return ScriptWorker::run(args.mid(2));
+    }
+
     QRegularExpression rxArgHelp(QStringLiteral("--help"));
     QRegularExpression rxArgH(QStringLiteral("-h"));
 
@@ -26,6 +26,7 @@
 #include "mainwindow.h"
 #include "widgets/toolbar.h"
 #include "imagearea.h"
+#include "canvasview.h"
 #include "datasingleton.h"
 #include "dialogs/settingsdialog.h"
 #include "widgets/palettebar.h"
@@ -38,7 +39,6 @@
 #include <QMenuBar>
 #include <QStatusBar>
 #include <QMessageBox>
-#include <QScrollArea>
 #include <QLabel>
 #include <QtEvents>
 #include <QPainter>
@@ -93,19 +93,32 @@ MainWindow::MainWindow(QStringList filePaths, QWidget *parent)
     if (DataSingleton::Instance()->getIsLoadScript())
     {
         mStatusLabel->setText(tr("Loading script..."));
-        mScriptModel = new ScriptModel(this, DataSingleton::Instance()->getVirtualEnvPath());
-        auto future = QtConcurrent::run([this, path = DataSingleton::Instance()->getScriptPath()] {
-            mScriptModel->LoadScript(path);
+        // Unless cached, the probe runs a child process: keep it off the startup path
+        auto future = QtConcurrent::run([venvPath = DataSingleton::Instance()->getVirtualEnvPath()] {
+            ScriptModel::isPythonInstalled(venvPath);
         });
         auto* watcher = new QFutureWatcher<void>(this);
-        connect(watcher, &QFutureWatcher<void>::finished, this, [this] {
-            mScriptModel->setupActions(mFileMenu, mEffectsMenu, mEffectsActMap);
-            mStatusLabel->setText(tr("Ready"));
-        });
+        connect(watcher, &QFutureWatcher<void>::finished, this, &MainWindow::initializeScriptModel);
         watcher->setFuture(future);
     }
 }
 
+void MainWindow::initializeScriptModel()
+{
+    mScriptModel = new ScriptModel(this, DataSingleton::Instance()->getVirtualEnvPath(),
+        DataSingleton::Instance()->getScriptWorkerCount());
+    connect(mScriptModel, SIGNAL(stateChanged(bool,qint64)), this, SLOT(setScriptStateToLabel(bool,qint64)));
+    auto future = QtConcurrent::run([this, path = DataSingleton::Instance()->getScriptPath()] {
+        mScriptModel->LoadScript(path);
+    });
+    auto* watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this] {
+        mScriptModel->setupActions(mFileMenu, mEffectsMenu, mEffectsActMap);
+        mStatusLabel->setText(tr("Ready"));
+    });
+    watcher->setFuture(future);
+}
+
 MainWindow::~MainWindow()
 {
     
@@ -143,12 +156,10 @@ ImageArea* MainWindow::initializeNewTab(bool openFile, bool askCanvasSize, const
         return nullptr;
     }
 
-    QScrollArea *scrollArea = new QScrollArea();
-    scrollArea->setAttribute(Qt::WA_DeleteOnClose);
-    scrollArea->setBackgroundRole(QPalette::Dark);
-    scrollArea->setWidget(imageArea);
+    CanvasView *canvasView = new CanvasView(imageArea);
+    canvasView->setAttribute(Qt::WA_DeleteOnClose);
 
-    mTabWidget->addTab(scrollArea, fileName);
+    mTabWidget->addTab(canvasView, fileName);
     mTabWidget->setCurrentIndex(mTabWidget->count()-1);
 
     mUndoStackGroup->addStack(imageArea->getUndoStack());
@@ -158,12 +169,16 @@ ImageArea* MainWindow::initializeNewTab(bool openFile, bool askCanvasSize, const
     connect(imageArea, SIGNAL(sendSetInstrument(InstrumentsEnum)), this, SLOT(setInstrument(InstrumentsEnum)));
     connect(imageArea, SIGNAL(sendNewImageSize(QSize)), this, SLOT(setNewSizeToSizeLabel(QSize)));
     connect(imageArea, SIGNAL(sendCursorPos(QPoint)), this, SLOT(setNewPosToPosLabel(QPoint)));
+    connect(imageArea, SIGNAL(sendUndoMemoryUsage(qint64)), this, SLOT(setUndoMemoryUsageToLabel(qint64)));
+    connect(imageArea, SIGNAL(sendLoadingFinished(bool)), this, SLOT(finishImageLoading(bool)));
+    connect(imageArea, SIGNAL(sendBusyChanged(bool)), this, SLOT(updateImageBusyState()));
     connect(imageArea, SIGNAL(sendColor(QColor)), this, SLOT(setCurrentPipetteColor(QColor)));
     connect(imageArea, SIGNAL(sendEnableCopyCutActions(bool)), this, SLOT(enableCopyCutActions(bool)));
     connect(imageArea, SIGNAL(sendEnableSelectionInstrument(bool)), this, SLOT(instumentsAct(bool)));
 
     setWindowTitle(QString("%1 - EasyPaint").arg(fileName));
-    setCurrentFile(imageArea->getFilePath());
+    if (!imageArea->isLoading())
+        setCurrentFile(imageArea->getFilePath());
     
     return imageArea;
 }
@@ -408,6 +423,8 @@ void MainWindow::initializeStatusBar()
     mPosLabel = new QLabel();
     mColorPreviewLabel = new QLabel();
     mColorRGBLabel = new QLabel();
+    mUndoMemoryLabel = new QLabel();
+    mScriptMemoryLabel = new QLabel();
 
     mStatusLabel->setText(tr("Ready"));
 
@@ -416,6 +433,8 @@ void MainWindow::initializeStatusBar()
     mStatusBar->addPermanentWidget(mPosLabel, 1);
     mStatusBar->addPermanentWidget(mColorPreviewLabel);
     mStatusBar->addPermanentWidget(mColorRGBLabel, -1);
+    mStatusBar->addPermanentWidget(mUndoMemoryLabel);
+    mStatusBar->addPermanentWidget(mScriptMemoryLabel);
 }
 
 void MainWindow::initializeToolBar()
@@ -435,18 +454,16 @@ void MainWindow::initializePaletteBar()
 ImageArea* MainWindow::getCurrentImageArea()
 {
     if (mTabWidget->currentWidget()) {
-        QScrollArea *tempScrollArea = qobject_cast<QScrollArea*>(mTabWidget->currentWidget());
-        ImageArea *tempArea = qobject_cast<ImageArea*>(tempScrollArea->widget());
-        return tempArea;
+        CanvasView *tempCanvasView = qobject_cast<CanvasView*>(mTabWidget->currentWidget());
+        return tempCanvasView->getImageArea();
     }
     return NULL;
 }
 
 ImageArea* MainWindow::getImageAreaByIndex(int index)
 {
-    QScrollArea *sa = static_cast<QScrollArea*>(mTabWidget->widget(index));
-    ImageArea *ia = static_cast<ImageArea*>(sa->widget());
-    return ia;
+    CanvasView *cv = static_cast<CanvasView*>(mTabWidget->widget(index));
+    return cv->getImageArea();
 }
 
 void MainWindow::activateTab(const int &index)
@@ -457,6 +474,7 @@ void MainWindow::activateTab(const int &index)
     getCurrentImageArea()->clearSelection();
     QSize size = getCurrentImageArea()->getImage()->size();
     mSizeLabel->setText(QString("%1 x %2").arg(size.width()).arg(size.height()));
+    setUndoMemoryUsageToLabel(getCurrentImageArea()->getUndoMemoryUsage());
 
     if(!getCurrentImageArea()->getFileName().isEmpty())
     {
@@ -479,6 +497,24 @@ void MainWindow::setNewPosToPosLabel(const QPoint &pos)
     mPosLabel->setText(QString("%1,%2").arg(pos.x()).arg(pos.y()));
 }
 
+void MainWindow::setUndoMemoryUsageToLabel(qint64 bytes)
+{
+    ImageArea *imageArea = qobject_cast<ImageArea*>(sender());
+    if (imageArea && imageArea != getCurrentImageArea())
+        return;
+    mUndoMemoryLabel->setText(tr("History: %1 MB").arg(bytes / (1024. * 1024.), 0, 'f', 1));
+}
+
+void MainWindow::setScriptStateToLabel(bool isLoaded, qint64 memoryBytes)
+{
+    const QString state = isLoaded ? tr("loaded") : tr("unloaded");
+    if (memoryBytes < 0)
+        mScriptMemoryLabel->setText(tr("Script: %1").arg(state));
+    else
+        mScriptMemoryLabel->setText(tr("Script: %1, %2 MB")
+            .arg(state).arg(memoryBytes / (1024. * 1024.), 0, 'f', 1));
+}
+
 void MainWindow::setCurrentPipetteColor(const QColor &color)
 {
     mColorRGBLabel->setText(QString("RGB: %1,%2,%3").arg(color.red())
@@ -680,6 +716,49 @@ void MainWindow::closeTab(int index)
     }
 }
 
+void MainWindow::finishImageLoading(bool isSuccess)
+{
+    ImageArea *imageArea = qobject_cast<ImageArea*>(sender());
+    int index = -1;
+    for (int i = 0; i < mTabWidget->count(); ++i)
+    {
+        if (getImageAreaByIndex(i) == imageArea)
+            index = i;
+    }
+    if (index == -1)
+        return;
+
+    if (!isSuccess)
+    {
+        // The area is still emitting, so its tab is destroyed later
+        mUndoStackGroup->removeStack(imageArea->getUndoStack());
+        QWidget *wid = mTabWidget->widget(index);
+        mTabWidget->removeTab(index);
+        wid->deleteLater();
+        if (mTabWidget->count() == 0)
+        {
+            setWindowTitle("Empty - EasyPaint");
+        }
+        return;
+    }
+
+    setCurrentFile(imageArea->getFilePath());
+    if (index == mTabWidget->currentIndex())
+    {
+        activateTab(index);
+        enableActions(index);
+    }
+}
+
+void MainWindow::updateImageBusyState()
+{
+    if (mTabWidget->currentIndex() != -1
+            && getImageAreaByIndex(mTabWidget->currentIndex()) == sender())
+    {
+        enableActions(mTabWidget->currentIndex());
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     if(!isSomethingModified() || closeAllTabs())
@@ -783,17 +862,20 @@ void MainWindow::enableActions(int index)
 {
     //if index == -1 it means, that there is no tabs
     bool isEnable = index == -1 ? false : true;
-
-    mToolsMenu->setEnabled(isEnable);
-    mEffectsMenu->setEnabled(isEnable);
-    mInstrumentsMenu->setEnabled(isEnable);
-    mToolbar->setEnabled(isEnable);
-    mPaletteBar->setEnabled(isEnable);
-
-    mSaveAction->setEnabled(isEnable);
-    mSaveAsAction->setEnabled(isEnable);
+    //image of the tab can't be edited until it is loaded and script jobs on it are done
+    bool isReady = isEnable && !getImageAreaByIndex(index)->isBusy();
+
+    mToolsMenu->setEnabled(isReady);
+    mEffectsMenu->setEnabled(isReady);
+    mInstrumentsMenu->setEnabled(isReady);
+    mToolbar->setEnabled(isReady);
+    mPaletteBar->setEnabled(isReady);
+    mPasteAction->setEnabled(isReady);
+
+    mSaveAction->setEnabled(isReady);
+    mSaveAsAction->setEnabled(isReady);
     mCloseAction->setEnabled(isEnable);
-    mPrintAction->setEnabled(isEnable);
+    mPrintAction->setEnabled(isReady);
 
     if(!isEnable)
     {
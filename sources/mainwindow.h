@@ -73,6 +73,10 @@ private:
     void initializeToolBar();
     void initializePaletteBar();
     void initializeTabWidget();
+    /**
+     * @brief Starts embedded Python and loads the script, once Python was probed.
+     */
+    void initializeScriptModel();
     /**
      * @brief Get current ImageArea from current tab.
      *
@@ -101,7 +105,8 @@ private:
     QTabWidget *mTabWidget;
     ToolBar *mToolbar;
     PaletteBar *mPaletteBar;
-    QLabel *mStatusLabel, *mSizeLabel, *mPosLabel, *mColorPreviewLabel, *mColorRGBLabel;
+    QLabel *mStatusLabel, *mSizeLabel, *mPosLabel, *mColorPreviewLabel, *mColorRGBLabel, *mUndoMemoryLabel,
+        *mScriptMemoryLabel;
 
     QMap<InstrumentsEnum, QAction*> mInstrumentsActMap;
     QMap<int, QAction*> mEffectsActMap;
@@ -121,6 +126,8 @@ private slots:
     void activateTab(const int &index);
     void setNewSizeToSizeLabel(const QSize &size);
     void setNewPosToPosLabel(const QPoint &pos);
+    void setUndoMemoryUsageToLabel(qint64 bytes);
+    void setScriptStateToLabel(bool isLoaded, qint64 memoryBytes);
     void setCurrentPipetteColor(const QColor &color);
     void clearStatusBarColor();
     void setInstrumentChecked(InstrumentsEnum instrument);
@@ -144,6 +151,16 @@ private slots:
     void advancedZoomAct();
     void closeTabAct();
     void closeTab(int index);
+    /**
+     * @brief Replaces placeholder of the loaded image or drops its tab if loading failed.
+     *
+     */
+    void finishImageLoading(bool isSuccess);
+    /**
+     * @brief Locks or unlocks actions when script jobs of the current tab start or finish.
+     *
+     */
+    void updateImageBusyState();
     void setAllInstrumentsUnchecked(QAction *action);
     /**
      * @brief Instruments buttons handler.
@@ -0,0 +1,110 @@
+#include "scriptjobqueue.h"
+#include "imagearea.h"
+
+#include "effects/effectruncallback.h"
+
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentRun>
+
+ScriptJobQueue::ScriptJobQueue(ImageArea *imageArea) :
+    QObject(imageArea), mImageArea(imageArea)
+{
+    connect(&mWatcher, SIGNAL(finished()), this, SLOT(jobFinished()));
+}
+
+ScriptJobQueue::~ScriptJobQueue()
+{
+    if (mCallback)
+        mCallback->interrupt();
+}
+
+void ScriptJobQueue::submit(const QString &title, Task task, Completion completion)
+{
+    const bool wasBusy = isBusy();
+    mPending.enqueue(Job{title, std::move(task), std::move(completion)});
+    if (!mIsRunning)
+        startNext();
+    else
+        updatePanel();
+    if (!wasBusy)
+        emit busyChanged(true);
+}
+
+void ScriptJobQueue::cancel()
+{
+    mPending.clear();
+    if (mCallback)
+        mCallback->interrupt();
+    updatePanel();
+}
+
+void ScriptJobQueue::startNext()
+{
+    if (mPending.isEmpty())
+    {
+        mIsRunning = false;
+        mCurrent = Job();
+        updatePanel();
+        emit busyChanged(false);
+        return;
+    }
+
+    mIsRunning = true;
+    mCurrent = mPending.dequeue();
+    mCallback.reset(new EffectRunCallback(), std::mem_fn(&QObject::deleteLater));
+    std::weak_ptr<EffectRunCallback> callback = mCallback;
+    Task task = mCurrent.task;
+    mWatcher.setFuture(QtConcurrent::run([task, callback]() { return task(callback); }));
+    updatePanel();
+}
+
+void ScriptJobQueue::jobFinished()
+{
+    const QVariant result = mWatcher.result();
+    const bool isInterrupted = mCallback->isInterrupted();
+    mCallback.reset();
+    if (!isInterrupted && mImageArea && mCurrent.completion)
+        mCurrent.completion(mImageArea, result);
+    startNext();
+}
+
+void ScriptJobQueue::updatePanel()
+{
+    if (!mImageArea)
+        return;
+    if (!mIsRunning)
+    {
+        if (mPanel)
+            mPanel->hide();
+        return;
+    }
+
+    if (!mPanel)
+    {
+        mPanel = new QWidget(mImageArea);
+        QVBoxLayout *layout = new QVBoxLayout(mPanel);
+        mPanelLabel = new QLabel(mPanel);
+        QProgressBar *progressBar = new QProgressBar(mPanel);
+        progressBar->setRange(0, 0);
+        QPushButton *cancelButton = new QPushButton(tr("Cancel"), mPanel);
+        connect(cancelButton, SIGNAL(clicked()), this, SLOT(cancel()));
+        layout->addWidget(mPanelLabel);
+        layout->addWidget(progressBar);
+        layout->addWidget(cancelButton, 0, Qt::AlignRight);
+        mPanel->setAutoFillBackground(true);
+        mPanel->move(10, 10);
+    }
+
+    QString text = (mCallback && mCallback->isInterrupted())
+            ? tr("Cancelling \"%1\"...").arg(mCurrent.title)
+            : tr("Running \"%1\"...").arg(mCurrent.title);
+    if (!mPending.isEmpty())
+        text += '\n' + tr("%n more queued", "", mPending.size());
+    mPanelLabel->setText(text);
+    mPanel->adjustSize();
+    mPanel->show();
+    mPanel->raise();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QVariant>
+
+#include <functional>
+#include <memory>
+
+class ImageArea;
+class EffectRunCallback;
+class QLabel;
+class QWidget;
+
+/**
+ * @brief Script effects waiting for or running on behalf of one image.
+ *
+ * Jobs run one after another on the thread pool while the image area shows a
+ * panel with the running job and a Cancel button. Completion handlers are
+ * called on the GUI thread, only for jobs which were not cancelled.
+ */
+class ScriptJobQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief Runs on a pool thread, callback reports interruption and previews. */
+    using Task = std::function<QVariant(std::weak_ptr<EffectRunCallback> callback)>;
+    /** @brief Applies result of the task to the image area. */
+    using Completion = std::function<void(ImageArea *imageArea, const QVariant &result)>;
+
+    explicit ScriptJobQueue(ImageArea *imageArea);
+    /**
+     * @brief Interrupts running job, its result is dropped.
+     */
+    ~ScriptJobQueue();
+
+    void submit(const QString &title, Task task, Completion completion);
+    bool isBusy() const { return mIsRunning || !mPending.isEmpty(); }
+
+public slots:
+    /**
+     * @brief Drop pending jobs and interrupt the running one.
+     */
+    void cancel();
+
+signals:
+    void busyChanged(bool isBusy);
+
+private slots:
+    void jobFinished();
+
+private:
+    struct Job
+    {
+        QString title;
+        Task task;
+        Completion completion;
+    };
+
+    void startNext();
+    void updatePanel();
+
+    QPointer<ImageArea> mImageArea;
+    QQueue<Job> mPending;
+    Job mCurrent;
+    bool mIsRunning = false;
+    std::shared_ptr<EffectRunCallback> mCallback; /**< Of the running job. */
+    QFutureWatcher<QVariant> mWatcher;
+
+    QWidget *mPanel = nullptr;
+    QLabel *mPanelLabel = nullptr;
+};
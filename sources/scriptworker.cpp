@@ -0,0 +1,204 @@
+#include "scriptworker.h"
+#include "ScriptModel.h"
+
+#include "effects/effectruncallback.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+using namespace ScriptWorkerProtocol;
+
+ScriptWorker::ScriptWorker(const QString &serverName, const QString &scriptPath, const QString &venvPath) :
+    mScriptModel(new ScriptModel(nullptr, venvPath))
+{
+    mScriptModel->LoadScript(scriptPath);
+
+    // Listen only when the script is loaded, the editor keeps connecting until then
+    mServer = new QLocalServer(this);
+    QLocalServer::removeServer(serverName);
+    if (!mServer->listen(serverName))
+        qWarning() << "Script worker can't listen on" << serverName << ":" << mServer->errorString();
+    connect(mServer, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+    connect(&mCallWatcher, SIGNAL(finished()), this, SLOT(callFinished()));
+}
+
+ScriptWorker::~ScriptWorker()
+{
+    if (mCallback)
+        mCallback->interrupt();
+    mCallWatcher.waitForFinished();
+}
+
+int ScriptWorker::run(const QStringList &arguments)
+{
+    if (arguments.size() < 2)
+    {
+        qWarning() << SCRIPT_WORKER_OPTION << "requires server name and script path";
+        return 1;
+    }
+
+    // The editor never writes to our input, end of it means the editor is gone
+    std::thread([] {
+        while (std::fgetc(stdin) != EOF)
+            ;
+        QMetaObject::invokeMethod(qApp, "quit", Qt::QueuedConnection);
+    }).detach();
+
+    ScriptWorker worker(arguments.at(0), arguments.at(1), arguments.value(2));
+    return qApp->exec();
+}
+
+void ScriptWorker::acceptConnection()
+{
+    // Calls are serialized by the editor, a new connection replaces a dropped one
+    if (mSocket || mCallWatcher.isRunning())
+        return;
+    mSocket = mServer->nextPendingConnection();
+    if (!mSocket)
+        return;
+    connect(mSocket, SIGNAL(readyRead()), this, SLOT(readMessages()));
+    connect(mSocket, SIGNAL(disconnected()), this, SLOT(closeConnection()));
+    readMessages();
+}
+
+void ScriptWorker::readMessages()
+{
+    if (!mSocket)
+        return;
+    mBuffer += mSocket->readAll();
+    QByteArray message;
+    while (takeMessage(mBuffer, message))
+        handleMessage(message);
+}
+
+void ScriptWorker::handleMessage(const QByteArray &message)
+{
+    QDataStream stream(message);
+    stream.setVersion(streamVersion());
+    quint8 type = 0;
+    stream >> type;
+
+    switch (type)
+    {
+    case DESCRIBE:
+    {
+        QByteArray reply;
+        QDataStream out(&reply, QIODevice::WriteOnly);
+        out.setVersion(streamVersion());
+        const std::vector<FunctionInfo> &infos = mScriptModel->getFunctionInfos();
+        out << quint8(FUNCTIONS) << quint32(infos.size());
+        for (const FunctionInfo &info : infos)
+            out << info;
+        send(reply);
+        break;
+    }
+    case CALL:
+    {
+        if (mCallWatcher.isRunning())
+            break;
+        QString callable;
+        qint32 maxFps = 0;
+        quint32 count = 0;
+        stream >> callable >> maxFps >> count;
+        QVariantList args;
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+            args << readValue(stream);
+        QVariantMap kwargs;
+        stream >> kwargs;
+
+        mCallback.reset(new EffectRunCallback(maxFps), std::mem_fn(&QObject::deleteLater));
+        connect(mCallback.get(), SIGNAL(imageReady()), this, SLOT(sendPreview()));
+        std::weak_ptr<EffectRunCallback> callback = mCallback;
+        ScriptModel *scriptModel = mScriptModel.get();
+        mCallWatcher.setFuture(QtConcurrent::run([=]() {
+            return scriptModel->call(callable, args, callback, kwargs);
+        }));
+        break;
+    }
+    case INTERRUPT:
+        if (mCallback)
+            mCallback->interrupt();
+        break;
+    case PREVIEW_DONE:
+        mPreviewSegment.reset();
+        sendPreview();
+        break;
+    default:
+        qWarning() << "Script worker got unknown message" << type;
+        break;
+    }
+}
+
+void ScriptWorker::sendPreview()
+{
+    // Frame stays in the mailbox while the previous one is in flight, so the
+    // script skips building new ones meanwhile
+    if (!mCallback || !mSocket || mPreviewSegment)
+        return;
+    const QImage image = mCallback->takeImage();
+    if (image.isNull())
+        return;
+    mPreviewSegment = shareImage(image);
+    if (!mPreviewSegment)
+        return;
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(streamVersion());
+    out << quint8(PREVIEW) << mPreviewSegment->key();
+    send(message);
+}
+
+void ScriptWorker::callFinished()
+{
+    const QVariant result = mCallWatcher.result();
+    mCallback.reset();
+    mPreviewSegment.reset();
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(streamVersion());
+    out << quint8(RESULT);
+    // Segment lives until the editor closes the connection after reading it
+    Segments segments;
+    writeValue(out, result, segments);
+    mResultSegment = segments.empty() ? nullptr : std::move(segments.front());
+    send(message);
+
+    if (!mSocket)
+        closeConnection();
+}
+
+void ScriptWorker::closeConnection()
+{
+    if (mSocket)
+    {
+        mSocket->deleteLater();
+        mSocket = nullptr;
+    }
+    mBuffer.clear();
+    // The editor gave up on the call, let the script stop at its next check;
+    // the next connection is taken once it finishes
+    if (mCallWatcher.isRunning())
+    {
+        if (mCallback)
+            mCallback->interrupt();
+        return;
+    }
+    mResultSegment.reset();
+    mPreviewSegment.reset();
+    acceptConnection();
+}
+
+void ScriptWorker::send(const QByteArray &message)
+{
+    if (mSocket)
+        sendMessage(*mSocket, message);
+}
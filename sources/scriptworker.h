@@ -0,0 +1,59 @@
+#pragma once
+
+#include "scriptworkerprotocol.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+
+#include <memory>
+
+class QLocalServer;
+class QLocalSocket;
+class ScriptModel;
+class EffectRunCallback;
+
+const char SCRIPT_WORKER_OPTION[] = "--scriptWorker";
+
+/**
+ * @brief Script side of the worker process started with SCRIPT_WORKER_OPTION.
+ *
+ * Loads the script into an embedded interpreter and serves one editor
+ * connection at a time on a QLocalServer. The process quits once its standard
+ * input is closed, which also happens when the editor crashes.
+ */
+class ScriptWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScriptWorker(const QString &serverName, const QString &scriptPath, const QString &venvPath);
+    ~ScriptWorker();
+
+    /**
+     * @brief Entry point, arguments are those following SCRIPT_WORKER_OPTION.
+     *
+     * @return Process exit code.
+     */
+    static int run(const QStringList &arguments);
+
+private slots:
+    void acceptConnection();
+    void readMessages();
+    void callFinished();
+    void sendPreview();
+    void closeConnection();
+
+private:
+    void handleMessage(const QByteArray &message);
+    void send(const QByteArray &message);
+
+    std::unique_ptr<ScriptModel> mScriptModel;
+    QLocalServer *mServer;
+    QLocalSocket *mSocket = nullptr;
+    QByteArray mBuffer;
+
+    std::shared_ptr<EffectRunCallback> mCallback;
+    QFutureWatcher<QVariant> mCallWatcher;
+    std::unique_ptr<QSharedMemory> mPreviewSegment; /**< Frame the editor hasn't confirmed yet. */
+    std::unique_ptr<QSharedMemory> mResultSegment;
+};
@@ -0,0 +1,318 @@
+#include "scriptworkerpool.h"
+#include "scriptworker.h"
+#include "scriptworkerprotocol.h"
+
+#include "effects/effectruncallback.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLocalSocket>
+#include <QThread>
+
+#include <stdexcept>
+
+using namespace ScriptWorkerProtocol;
+
+/**
+ * @brief Blocking connection to a worker, used on the calling thread.
+ */
+class ScriptWorkerPool::Connection
+{
+public:
+    explicit Connection(ScriptWorkerPool *pool, std::weak_ptr<EffectRunCallback> callback = {}) :
+        mPool(pool), mIndex(pool->acquire()), mCallback(callback)
+    {
+        // The worker listens only after loading the script, which may take long
+        const QString serverName = pool->mWorkers.at(mIndex).serverName;
+        for (;;)
+        {
+            mSocket.connectToServer(serverName);
+            if (mSocket.waitForConnected(1000))
+                break;
+            if (isInterrupted() || !mPool->isRunning(mIndex))
+            {
+                mPool->release(mIndex);
+                throw std::runtime_error("Script worker is not running");
+            }
+            QThread::msleep(200);
+        }
+    }
+
+    ~Connection()
+    {
+        mSocket.disconnectFromServer();
+        mPool->release(mIndex);
+    }
+
+    void send(const QByteArray &message)
+    {
+        sendMessage(mSocket, message);
+        mSocket.waitForBytesWritten();
+    }
+
+    /**
+     * @brief Wait for next message, forwarding interruption meanwhile.
+     */
+    QByteArray receive()
+    {
+        QByteArray message;
+        while (!takeMessage(mBuffer, message))
+        {
+            if (!mIsInterruptSent && isInterrupted())
+            {
+                QByteArray interrupt;
+                QDataStream out(&interrupt, QIODevice::WriteOnly);
+                out.setVersion(streamVersion());
+                out << quint8(INTERRUPT);
+                send(interrupt);
+                mIsInterruptSent = true;
+            }
+            if (mSocket.waitForReadyRead(100))
+                mBuffer += mSocket.readAll();
+            else if (mSocket.state() != QLocalSocket::ConnectedState)
+                throw std::runtime_error("Script worker exited");
+        }
+        return message;
+    }
+
+private:
+    bool isInterrupted()
+    {
+        auto callback = mCallback.lock();
+        return callback && callback->isInterrupted();
+    }
+
+    ScriptWorkerPool *mPool;
+    int mIndex;
+    std::weak_ptr<EffectRunCallback> mCallback;
+    QLocalSocket mSocket;
+    QByteArray mBuffer;
+    bool mIsInterruptSent = false;
+};
+
+ScriptWorkerPool::ScriptWorkerPool(const QString &venvPath, int workerCount, QObject *parent) :
+    QObject(parent), mVenvPath(venvPath)
+{
+    mWorkers.resize(qMax(workerCount, 1));
+    for (int i = 0; i < mWorkers.size(); ++i)
+    {
+        mWorkers[i].serverName = QString("easypaint_script_%1_%2")
+                .arg(QCoreApplication::applicationPid()).arg(i);
+    }
+}
+
+ScriptWorkerPool::~ScriptWorkerPool()
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mIsShuttingDown = true;
+        mStateChanged.wakeAll();
+    }
+    for (Worker &worker : mWorkers)
+    {
+        if (!worker.process)
+            continue;
+        worker.process->disconnect(this);
+        worker.process->closeWriteChannel();
+        if (!worker.process->waitForFinished(3000))
+            worker.process->kill();
+    }
+
+    // Calls in progress fail once their workers are gone, wait for them to leave
+    QMutexLocker locker(&mMutex);
+    while (mUserCount > 0)
+        mStateChanged.wait(&mMutex);
+}
+
+void ScriptWorkerPool::start(const QString &scriptPath)
+{
+    // Processes belong to the pool thread
+    QMetaObject::invokeMethod(this, "startWorkers",
+                              thread() == QThread::currentThread() ? Qt::DirectConnection : Qt::BlockingQueuedConnection,
+                              Q_ARG(QString, scriptPath));
+}
+
+void ScriptWorkerPool::startWorkers(const QString &scriptPath)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mScriptPath = scriptPath;
+    }
+    for (int i = 0; i < mWorkers.size(); ++i)
+        startWorker(i);
+}
+
+void ScriptWorkerPool::startWorker(int index)
+{
+    Worker &worker = mWorkers[index];
+    if (!worker.process)
+    {
+        worker.process = new QProcess(this);
+        worker.process->setProcessChannelMode(QProcess::ForwardedChannels);
+        connect(worker.process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(workerFinished()));
+    }
+    worker.process->start(QCoreApplication::applicationFilePath(),
+                          QStringList() << SCRIPT_WORKER_OPTION << worker.serverName << mScriptPath << mVenvPath);
+    const bool isStarted = worker.process->waitForStarted();
+
+    QMutexLocker locker(&mMutex);
+    worker.isRunning = isStarted;
+    mStateChanged.wakeAll();
+}
+
+void ScriptWorkerPool::workerFinished()
+{
+    QProcess *process = qobject_cast<QProcess*>(sender());
+    for (int i = 0; i < mWorkers.size(); ++i)
+    {
+        Worker &worker = mWorkers[i];
+        if (worker.process != process)
+            continue;
+
+        qWarning() << "Script worker" << i << "exited with code" << process->exitCode();
+        bool isRestarting;
+        {
+            // A worker being restarted stays available, calls wait until it listens again
+            QMutexLocker locker(&mMutex);
+            isRestarting = !mIsShuttingDown && worker.restartCount < MAX_RESTARTS;
+            worker.isRunning = isRestarting;
+            mStateChanged.wakeAll();
+        }
+        if (isRestarting)
+        {
+            ++worker.restartCount;
+            startWorker(i);
+        }
+    }
+}
+
+int ScriptWorkerPool::acquire()
+{
+    QMutexLocker locker(&mMutex);
+    ++mUserCount;
+    for (;;)
+    {
+        if (mIsShuttingDown)
+        {
+            --mUserCount;
+            mStateChanged.wakeAll();
+            throw std::runtime_error("Script workers are shutting down");
+        }
+        bool hasRunning = false;
+        for (int i = 0; i < mWorkers.size(); ++i)
+        {
+            if (!mWorkers[i].isRunning)
+                continue;
+            hasRunning = true;
+            if (!mWorkers[i].isBusy)
+            {
+                mWorkers[i].isBusy = true;
+                return i;
+            }
+        }
+        if (!hasRunning && !mScriptPath.isEmpty())
+        {
+            --mUserCount;
+            mStateChanged.wakeAll();
+            throw std::runtime_error("No script worker is running");
+        }
+        mStateChanged.wait(&mMutex);
+    }
+}
+
+void ScriptWorkerPool::release(int index)
+{
+    QMutexLocker locker(&mMutex);
+    mWorkers[index].isBusy = false;
+    --mUserCount;
+    mStateChanged.wakeAll();
+}
+
+bool ScriptWorkerPool::isRunning(int index)
+{
+    QMutexLocker locker(&mMutex);
+    return mWorkers.at(index).isRunning && !mIsShuttingDown;
+}
+
+std::vector<FunctionInfo> ScriptWorkerPool::describe()
+{
+    Connection connection(this);
+
+    QByteArray request;
+    QDataStream out(&request, QIODevice::WriteOnly);
+    out.setVersion(streamVersion());
+    out << quint8(DESCRIBE);
+    connection.send(request);
+
+    const QByteArray reply = connection.receive();
+    QDataStream in(reply);
+    in.setVersion(streamVersion());
+    quint8 type = 0;
+    quint32 count = 0;
+    in >> type >> count;
+    if (type != FUNCTIONS)
+        throw std::runtime_error("Unexpected reply of script worker");
+
+    std::vector<FunctionInfo> infos;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        FunctionInfo info;
+        in >> info;
+        infos.push_back(std::move(info));
+    }
+    return infos;
+}
+
+QVariant ScriptWorkerPool::call(const QString &callable, const QVariantList &args,
+                                std::weak_ptr<EffectRunCallback> callback, const QVariantMap &kwargs)
+{
+    int maxFps = 0;
+    if (auto obj = callback.lock())
+    {
+        if (obj->isInterrupted())
+            return QVariant();
+        maxFps = obj->getMaxFps();
+    }
+
+    Connection connection(this, callback);
+
+    // Argument images stay shared until the call returns
+    Segments segments;
+    QByteArray request;
+    QDataStream out(&request, QIODevice::WriteOnly);
+    out.setVersion(streamVersion());
+    out << quint8(CALL) << callable << qint32(maxFps) << quint32(args.size());
+    for (const QVariant &arg : args)
+        writeValue(out, arg, segments);
+    out << kwargs;
+    connection.send(request);
+
+    for (;;)
+    {
+        const QByteArray message = connection.receive();
+        QDataStream in(message);
+        in.setVersion(streamVersion());
+        quint8 type = 0;
+        in >> type;
+
+        if (type == RESULT)
+            return readValue(in);
+
+        if (type == PREVIEW)
+        {
+            QString key;
+            in >> key;
+            const QImage image = readSharedImage(key);
+            if (auto obj = callback.lock())
+            {
+                if (!image.isNull())
+                    obj->postImage(image);
+            }
+            QByteArray done;
+            QDataStream doneOut(&done, QIODevice::WriteOnly);
+            doneOut.setVersion(streamVersion());
+            doneOut << quint8(PREVIEW_DONE);
+            connection.send(done);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ScriptInfo.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QProcess>
+#include <QVariant>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+class EffectRunCallback;
+
+/**
+ * @brief Script worker processes run by the editor.
+ *
+ * Each worker is this binary started with SCRIPT_WORKER_OPTION; it embeds its
+ * own interpreter, so calls on different workers run concurrently and a
+ * crashing extension takes down only its worker, which is restarted.
+ * describe() and call() block the calling thread and are meant for thread
+ * pool threads; processes themselves are managed on the thread of the pool.
+ */
+class ScriptWorkerPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScriptWorkerPool(const QString &venvPath, int workerCount, QObject *parent = nullptr);
+    /**
+     * @brief Closes input of workers so they quit, kills ones which don't.
+     */
+    ~ScriptWorkerPool();
+
+    /**
+     * @brief Start worker processes loading the script, may be called from any thread.
+     */
+    void start(const QString &scriptPath);
+
+    /**
+     * @brief Functions of the loaded script, as reported by a worker.
+     *
+     * @throw std::runtime_error if no worker could answer.
+     */
+    std::vector<FunctionInfo> describe();
+    /**
+     * @brief Call script function on an idle worker, waiting for one if all are busy.
+     *
+     * Preview frames are posted to callback, its interruption is forwarded.
+     * @throw std::runtime_error if the worker exited during the call.
+     */
+    QVariant call(const QString &callable, const QVariantList &args,
+                  std::weak_ptr<EffectRunCallback> callback, const QVariantMap &kwargs);
+
+private slots:
+    void startWorkers(const QString &scriptPath);
+    void workerFinished();
+
+private:
+    enum { MAX_RESTARTS = 3 };
+
+    struct Worker
+    {
+        QProcess *process = nullptr;
+        QString serverName;
+        bool isRunning = false;
+        bool isBusy = false;
+        int restartCount = 0;
+    };
+
+    class Connection;
+
+    void startWorker(int index);
+    int acquire();
+    void release(int index);
+    bool isRunning(int index);
+
+    QString mVenvPath;
+    QString mScriptPath;
+    QVector<Worker> mWorkers;
+    QMutex mMutex; /**< Guards state flags of mWorkers and mScriptPath. */
+    QWaitCondition mStateChanged;
+    bool mIsShuttingDown = false;
+    int mUserCount = 0; /**< Threads inside acquire() or holding a worker. */
+};
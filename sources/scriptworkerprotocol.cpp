@@ -0,0 +1,160 @@
+#include "scriptworkerprotocol.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLocalSocket>
+
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+struct SharedImageHeader
+{
+    qint32 width;
+    qint32 height;
+    qint32 format;
+    qint32 bytesPerLine;
+};
+
+} // namespace
+
+QDataStream::Version ScriptWorkerProtocol::streamVersion()
+{
+    return QDataStream::Qt_5_12;
+}
+
+void ScriptWorkerProtocol::sendMessage(QLocalSocket &socket, const QByteArray &message)
+{
+    QByteArray packet;
+    QDataStream stream(&packet, QIODevice::WriteOnly);
+    stream.setVersion(streamVersion());
+    stream << quint32(message.size());
+    packet += message;
+    socket.write(packet);
+}
+
+bool ScriptWorkerProtocol::takeMessage(QByteArray &buffer, QByteArray &message)
+{
+    if (buffer.size() < int(sizeof(quint32)))
+        return false;
+    QDataStream stream(buffer);
+    stream.setVersion(streamVersion());
+    quint32 size = 0;
+    stream >> size;
+    if (quint64(buffer.size()) < sizeof(quint32) + quint64(size))
+        return false;
+    message = buffer.mid(sizeof(quint32), size);
+    buffer.remove(0, sizeof(quint32) + size);
+    return true;
+}
+
+std::unique_ptr<QSharedMemory> ScriptWorkerProtocol::shareImage(const QImage &image)
+{
+    static std::atomic<int> counter{0};
+    const QString key = QString("easypaint_image_%1_%2")
+            .arg(QCoreApplication::applicationPid()).arg(counter++);
+
+    SharedImageHeader header;
+    header.width = image.width();
+    header.height = image.height();
+    header.format = image.format();
+    header.bytesPerLine = int(image.bytesPerLine());
+    const qsizetype dataSize = image.bytesPerLine() * image.height();
+
+    auto segment = std::make_unique<QSharedMemory>(key);
+    if (!segment->create(int(sizeof(header) + dataSize)))
+    {
+        qWarning() << "Can't create shared memory for image:" << segment->errorString();
+        return nullptr;
+    }
+    char *data = static_cast<char*>(segment->data());
+    memcpy(data, &header, sizeof(header));
+    if (dataSize > 0)
+        memcpy(data + sizeof(header), image.constBits(), dataSize);
+    return segment;
+}
+
+QImage ScriptWorkerProtocol::readSharedImage(const QString &key)
+{
+    QSharedMemory segment(key);
+    if (!segment.attach(QSharedMemory::ReadOnly))
+    {
+        qWarning() << "Can't attach shared image" << key << ":" << segment.errorString();
+        return QImage();
+    }
+    const char *data = static_cast<const char*>(segment.constData());
+    SharedImageHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.width <= 0 || header.height <= 0)
+        return QImage();
+
+    QImage image(header.width, header.height, QImage::Format(header.format));
+    const qsizetype rowBytes = qMin<qsizetype>(header.bytesPerLine, image.bytesPerLine());
+    for (int y = 0; y < header.height; ++y)
+        memcpy(image.scanLine(y), data + sizeof(header) + qsizetype(y) * header.bytesPerLine, rowBytes);
+    return image;
+}
+
+void ScriptWorkerProtocol::writeValue(QDataStream &stream, const QVariant &value, Segments &segments)
+{
+    if (value.userType() == QMetaType::QImage)
+    {
+        std::unique_ptr<QSharedMemory> segment = shareImage(value.value<QImage>());
+        stream << true << (segment ? segment->key() : QString());
+        if (segment)
+            segments.push_back(std::move(segment));
+        return;
+    }
+    stream << false << value;
+}
+
+QVariant ScriptWorkerProtocol::readValue(QDataStream &stream)
+{
+    bool isImage = false;
+    stream >> isImage;
+    if (isImage)
+    {
+        QString key;
+        stream >> key;
+        return key.isEmpty() ? QVariant() : QVariant::fromValue(readSharedImage(key));
+    }
+    QVariant value;
+    stream >> value;
+    return value;
+}
+
+QDataStream &operator<<(QDataStream &stream, const ParameterInfo &info)
+{
+    return stream << info.name << info.fullName << info.kind << info.description
+                  << info.defaultValue << info.annotation;
+}
+
+QDataStream &operator>>(QDataStream &stream, ParameterInfo &info)
+{
+    return stream >> info.name >> info.fullName >> info.kind >> info.description
+                  >> info.defaultValue >> info.annotation;
+}
+
+QDataStream &operator<<(QDataStream &stream, const FunctionInfo &info)
+{
+    stream << info.name << info.fullName << info.signature << info.doc
+           << quint32(info.parameters.size());
+    for (const ParameterInfo &parameter : info.parameters)
+        stream << parameter;
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, FunctionInfo &info)
+{
+    quint32 count = 0;
+    stream >> info.name >> info.fullName >> info.signature >> info.doc >> count;
+    info.parameters.clear();
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        ParameterInfo parameter;
+        stream >> parameter;
+        info.parameters.push_back(std::move(parameter));
+    }
+    return stream;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ScriptInfo.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QImage>
+#include <QSharedMemory>
+#include <QVariant>
+
+#include <memory>
+#include <vector>
+
+class QLocalSocket;
+
+/**
+ * @brief Messages between editor and script worker processes.
+ *
+ * Every message is a 32-bit length followed by a QDataStream payload starting
+ * with MessageType. Images never go through the socket: they are written to a
+ * QSharedMemory segment and only its key is sent.
+ */
+namespace ScriptWorkerProtocol
+{
+    enum MessageType : quint8
+    {
+        DESCRIBE,     /**< Editor asks for functions of the loaded script. */
+        FUNCTIONS,    /**< Worker replies with FunctionInfo list. */
+        CALL,         /**< Editor calls function: name, max preview FPS, arguments, keyword arguments. */
+        INTERRUPT,    /**< Editor asks running call to stop. */
+        PREVIEW,      /**< Worker sends preview frame key, no other frame is sent until PREVIEW_DONE. */
+        PREVIEW_DONE, /**< Editor has read the preview frame. */
+        RESULT        /**< Worker sends return value of the call. */
+    };
+
+    using Segments = std::vector<std::unique_ptr<QSharedMemory>>;
+
+    QDataStream::Version streamVersion();
+
+    void sendMessage(QLocalSocket &socket, const QByteArray &message);
+    /**
+     * @brief Cut complete message from the front of received data.
+     */
+    bool takeMessage(QByteArray &buffer, QByteArray &message);
+
+    /**
+     * @brief Copy image into new shared memory segment, image is null if it failed.
+     */
+    std::unique_ptr<QSharedMemory> shareImage(const QImage &image);
+    QImage readSharedImage(const QString &key);
+
+    /**
+     * @brief Write value, QImage goes to a segment appended to segments.
+     */
+    void writeValue(QDataStream &stream, const QVariant &value, Segments &segments);
+    QVariant readValue(QDataStream &stream);
+}
+
+QDataStream &operator<<(QDataStream &stream, const ParameterInfo &info);
+QDataStream &operator>>(QDataStream &stream, ParameterInfo &info);
+QDataStream &operator<<(QDataStream &stream, const FunctionInfo &info);
+QDataStream &operator>>(QDataStream &stream, FunctionInfo &info);
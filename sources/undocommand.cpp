@@ -24,34 +24,168 @@
  */
 
 #include "undocommand.h"
+#include "undomemorymanager.h"
+
+#include <QUndoStack>
+
+void UndoCommand::Layer::compact(const QImage &current, const Layer *previous)
+{
+    isDelta = current.size() == prev.size() && current.format() == prev.format()
+        && ImageTileDelta::isSupported(current);
+    if (isDelta)
+    {
+        delta.build(prev, current, (previous && previous->isDelta)? &previous->delta : nullptr);
+        prev = QImage();
+    }
+    else
+    {
+        curr = current;
+    }
+}
+
+void UndoCommand::Layer::undo(QImage &image) const
+{
+    if (isDelta)
+        delta.applyBefore(image);
+    else
+        image = prev;
+}
+
+void UndoCommand::Layer::redo(QImage &image) const
+{
+    if (isDelta)
+        delta.applyAfter(image);
+    else
+        image = curr;
+}
+
+qint64 UndoCommand::Layer::memoryUsage(const QImage &current) const
+{
+    if (isDelta)
+        return delta.memoryUsage();
+
+    qint64 result = 0;
+    if (prev.constBits() != current.constBits())
+        result += prev.sizeInBytes();
+    if (curr.constBits() != current.constBits())
+        result += curr.sizeInBytes();
+    return result;
+}
+
+void UndoCommand::Layer::write(QDataStream &stream)
+{
+    stream << isDelta;
+    if (isDelta)
+    {
+        delta.write(stream);
+        delta.clear();
+    }
+    else
+    {
+        ImageTileDelta::writeImage(stream, prev);
+        ImageTileDelta::writeImage(stream, curr);
+        prev = curr = QImage();
+    }
+}
+
+void UndoCommand::Layer::read(QDataStream &stream)
+{
+    stream >> isDelta;
+    if (isDelta)
+    {
+        delta.read(stream);
+    }
+    else
+    {
+        prev = ImageTileDelta::readImage(stream);
+        curr = ImageTileDelta::readImage(stream);
+    }
+}
 
 UndoCommand::UndoCommand(ImageArea &imgArea, QUndoCommand *parent, bool fixSise)
-    : QUndoCommand(parent), mPrevImage(*imgArea.getImage()), mPrevMarkup(*imgArea.getMarkup()), 
-    mImageArea(imgArea), mFixSize(fixSise)
+    : QUndoCommand(parent), mImageArea(imgArea), mFixSize(fixSise)
+{
+    mImage.prev = *imgArea.getImage();
+    mMarkup.prev = *imgArea.getMarkup();
+}
+
+UndoCommand::~UndoCommand()
+{
+    if (mIsCompacted)
+        UndoMemoryManager::Instance()->remove(this);
+}
+
+void UndoCommand::compact()
+{
+    if (mIsCompacted)
+        return;
+    const UndoCommand *previous = previousCommand();
+    mImage.compact(*mImageArea.getImage(), previous? &previous->mImage : nullptr);
+    mMarkup.compact(*mImageArea.getMarkup(), previous? &previous->mMarkup : nullptr);
+    mIsCompacted = true;
+    UndoMemoryManager::Instance()->add(this);
+}
+
+qint64 UndoCommand::memoryUsage() const
+{
+    return mImage.memoryUsage(*mImageArea.getImage())
+        + mMarkup.memoryUsage(*mImageArea.getMarkup());
+}
+
+QByteArray UndoCommand::takeState()
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    mImage.write(stream);
+    mMarkup.write(stream);
+    return state;
+}
+
+void UndoCommand::restoreState(const QByteArray &state)
+{
+    QDataStream stream(state);
+    mImage.read(stream);
+    mMarkup.read(stream);
+}
+
+const UndoCommand *UndoCommand::previousCommand() const
 {
-    mCurrImage = mPrevImage;
-    mCurrMarkup = mPrevMarkup;
+    const QUndoStack *stack = mImageArea.getUndoStack();
+    for (int i = 1; i < stack->count(); ++i)
+    {
+        if (stack->command(i) == this)
+            return dynamic_cast<const UndoCommand*>(stack->command(i - 1));
+    }
+    return nullptr;
 }
 
 void UndoCommand::undo()
 {
     mImageArea.clearSelection();
-    mCurrImage = *(mImageArea.getImage());
-    mCurrMarkup = *(mImageArea.getMarkup());
-    mImageArea.setImage(mPrevImage);
-    mImageArea.setMarkup(mPrevMarkup);
+    compact();
+    // Keep the image as it is rather than apply a state which was lost
+    if (!UndoMemoryManager::Instance()->ensureResident(this))
+        return;
+    mImage.undo(*mImageArea.getImage());
+    mMarkup.undo(*mImageArea.getMarkup());
     if (mFixSize)
         mImageArea.fixSize(true);
-    mImageArea.update();
+    mImageArea.updateImageRect(mImageArea.getImage()->rect());
     mImageArea.saveImageChanges();
 }
 
 void UndoCommand::redo()
 {
-    mImageArea.setImage(mCurrImage);
-    mImageArea.setMarkup(mCurrMarkup);
+    // The very first redo comes from QUndoStack::push, image area is already in that state
+    if (mIsCompacted)
+    {
+        if (!UndoMemoryManager::Instance()->ensureResident(this))
+            return;
+        mImage.redo(*mImageArea.getImage());
+        mMarkup.redo(*mImageArea.getMarkup());
+    }
     if (mFixSize)
         mImageArea.fixSize(true);
-    mImageArea.update();
+    mImageArea.updateImageRect(mImageArea.getImage()->rect());
     mImageArea.saveImageChanges();
 }
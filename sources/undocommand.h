@@ -22,7 +22,6 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
-
 #ifndef UNDOCOMMAND_H
 #define UNDOCOMMAND_H
 
@@ -30,26 +29,67 @@
 #include <QImage>
 
 #include "imagearea.h"
+#include "imagetiledelta.h"
 
 /**
  * @brief Class which provides undo/redo actions
  *
- * In future it should be changed according to architecture changing
+ * Command keeps full snapshot of image while it is on top of the stack.
+ * When next command is pushed (or this one is undone) it is compacted
+ * to the tiles which were actually changed.
  */
 class UndoCommand : public QUndoCommand
 {
 public:
     UndoCommand(ImageArea &imgArea, QUndoCommand *parent = nullptr, bool fixSise = false);
+    ~UndoCommand() override;
 
     void undo() override;
     void redo() override;
+
+    /**
+     * @brief Replace snapshots with tiles changed since command creation.
+     *
+     * Current content of image area is taken as the state after command.
+     */
+    void compact();
+    bool isCompacted() const { return mIsCompacted; }
+    /**
+     * @brief Bytes held by command and not shared with image area or other commands.
+     */
+    qint64 memoryUsage() const;
+    /**
+     * @brief Serialize compacted state and release it from memory.
+     */
+    QByteArray takeState();
+    void restoreState(const QByteArray &state);
+
 private:
-    QImage mPrevImage;
-    QImage mCurrImage;
-    QImage mPrevMarkup;
-    QImage mCurrMarkup;
+    /**
+     * @brief History of one image area layer (image or markup).
+     */
+    struct Layer
+    {
+        QImage prev; /**< Full state before command, used until compacted or if size changed. */
+        QImage curr; /**< Full state after command, used if size changed. */
+        ImageTileDelta delta;
+        bool isDelta = false;
+
+        void compact(const QImage &current, const Layer *previous);
+        void undo(QImage &image) const;
+        void redo(QImage &image) const;
+        qint64 memoryUsage(const QImage &current) const;
+        void write(QDataStream &stream);
+        void read(QDataStream &stream);
+    };
+
+    const UndoCommand *previousCommand() const;
+
+    Layer mImage;
+    Layer mMarkup;
     ImageArea& mImageArea;
     bool mFixSize;
+    bool mIsCompacted = false;
 };
 
 #endif // UNDOCOMMAND_H
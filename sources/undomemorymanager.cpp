@@ -0,0 +1,181 @@
+#include "undomemorymanager.h"
+#include "undocommand.h"
+#include "datasingleton.h"
+
+#include <QDir>
+#include <QtCore/QDebug>
+
+UndoMemoryManager* UndoMemoryManager::Instance()
+{
+    // Function local instance, so the spill file is removed on exit
+    static UndoMemoryManager instance;
+    return &instance;
+}
+
+int UndoMemoryManager::indexOf(const UndoCommand *command) const
+{
+    for (int i = mEntries.size() - 1; i >= 0; --i)
+    {
+        if (mEntries[i].command == command)
+            return i;
+    }
+    return -1;
+}
+
+void UndoMemoryManager::add(UndoCommand *command)
+{
+    if (indexOf(command) != -1)
+        return;
+    Entry entry = { command, command->memoryUsage(), -1, 0 };
+    mEntries.append(entry);
+    mResidentBytes += entry.bytes;
+    enforceBudget(command);
+}
+
+void UndoMemoryManager::remove(UndoCommand *command)
+{
+    const int index = indexOf(command);
+    if (index == -1)
+        return;
+    const Entry &entry = mEntries[index];
+    if (entry.offset < 0)
+    {
+        mResidentBytes -= entry.bytes;
+    }
+    else
+    {
+        mSpilledBytes -= entry.size;
+        freeExtent(entry.offset, entry.size);
+    }
+    mEntries.removeAt(index);
+}
+
+bool UndoMemoryManager::ensureResident(UndoCommand *command)
+{
+    const int index = indexOf(command);
+    if (index == -1)
+        return true;
+    Entry &entry = mEntries[index];
+    if (entry.offset >= 0)
+    {
+        QByteArray data;
+        if (mSpillFile.seek(entry.offset))
+            data = mSpillFile.read(entry.size);
+        const QByteArray state = data.size() == entry.size ? qUncompress(data) : QByteArray();
+        if (state.isEmpty())
+        {
+            // Entry stays spilled, the command keeps no state to apply
+            qWarning() << "Failed to read undo history from" << mSpillFile.fileName();
+            return false;
+        }
+        command->restoreState(state);
+        mSpilledBytes -= entry.size;
+        freeExtent(entry.offset, entry.size);
+        entry.bytes = command->memoryUsage();
+        entry.offset = -1;
+        entry.size = 0;
+        mResidentBytes += entry.bytes;
+    }
+    mEntries.move(index, mEntries.size() - 1);
+    enforceBudget(command);
+    return true;
+}
+
+void UndoMemoryManager::enforceBudget(const UndoCommand *keep)
+{
+    // Sizes change when a command sharing tiles with the next one is dropped from history
+    mResidentBytes = 0;
+    for (Entry &entry : mEntries)
+    {
+        if (entry.offset >= 0)
+            continue;
+        entry.bytes = entry.command->memoryUsage();
+        mResidentBytes += entry.bytes;
+    }
+
+    const qint64 limit = qint64(DataSingleton::Instance()->getHistoryMemoryLimit()) * 1024 * 1024;
+    for (int i = 0; i < mEntries.size() && mResidentBytes > limit; ++i)
+    {
+        Entry &entry = mEntries[i];
+        if (entry.offset >= 0 || entry.command == keep)
+            continue;
+        if (!spill(entry))
+            break;
+    }
+}
+
+bool UndoMemoryManager::spill(Entry &entry)
+{
+    if (!mSpillFile.isOpen())
+    {
+        mSpillFile.setFileTemplate(QDir(QDir::tempPath()).filePath("easypaint_undo_XXXXXX"));
+        if (!mSpillFile.open())
+        {
+            qWarning() << "Can't create undo history file in" << QDir::tempPath();
+            return false;
+        }
+    }
+
+    // Level 1 is a good deal faster than default and still shrinks flat areas well
+    const QByteArray data = qCompress(entry.command->takeState(), 1);
+    const qint64 offset = allocateExtent(data.size());
+    if (!mSpillFile.seek(offset) || mSpillFile.write(data) != data.size())
+    {
+        qWarning() << "Failed to write undo history to" << mSpillFile.fileName();
+        freeExtent(offset, data.size());
+        entry.command->restoreState(qUncompress(data));
+        return false;
+    }
+    mResidentBytes -= entry.bytes;
+    mSpilledBytes += data.size();
+    entry.offset = offset;
+    entry.size = data.size();
+    return true;
+}
+
+qint64 UndoMemoryManager::allocateExtent(qint64 size)
+{
+    // First fit, states are of similar size so holes get reused quickly
+    for (int i = 0; i < mFreeExtents.size(); ++i)
+    {
+        Extent &extent = mFreeExtents[i];
+        if (extent.size < size)
+            continue;
+        const qint64 offset = extent.offset;
+        extent.offset += size;
+        extent.size -= size;
+        if (extent.size == 0)
+            mFreeExtents.removeAt(i);
+        return offset;
+    }
+    return mSpillFile.size();
+}
+
+void UndoMemoryManager::freeExtent(qint64 offset, qint64 size)
+{
+    int index = 0;
+    while (index < mFreeExtents.size() && mFreeExtents[index].offset < offset)
+        ++index;
+    mFreeExtents.insert(index, { offset, size });
+
+    // Merge with neighbours
+    if (index + 1 < mFreeExtents.size()
+            && mFreeExtents[index].offset + mFreeExtents[index].size == mFreeExtents[index + 1].offset)
+    {
+        mFreeExtents[index].size += mFreeExtents[index + 1].size;
+        mFreeExtents.removeAt(index + 1);
+    }
+    if (index > 0 && mFreeExtents[index - 1].offset + mFreeExtents[index - 1].size == mFreeExtents[index].offset)
+    {
+        mFreeExtents[index - 1].size += mFreeExtents[index].size;
+        mFreeExtents.removeAt(index);
+    }
+
+    // Give the tail back to the file system
+    const Extent &last = mFreeExtents.last();
+    if (last.offset + last.size >= mSpillFile.size())
+    {
+        mSpillFile.resize(last.offset);
+        mFreeExtents.removeLast();
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QList>
+#include <QTemporaryFile>
+
+class UndoCommand;
+
+/**
+ * @brief Keeps undo history of all tabs within memory budget.
+ *
+ * Compacted commands are tracked in least recently used order. When their total
+ * size exceeds DataSingleton::getHistoryMemoryLimit(), the oldest ones are
+ * compressed to a temporary file and read back on undo/redo. Space of states
+ * which were read back or dropped is reused and a free tail is truncated, so
+ * the file doesn't keep growing over a long session.
+ */
+class UndoMemoryManager
+{
+public:
+    static UndoMemoryManager* Instance();
+
+    /**
+     * @brief Start tracking compacted command, may spill older ones to disk.
+     */
+    void add(UndoCommand *command);
+    void remove(UndoCommand *command);
+    /**
+     * @brief Load command state back from disk if it was spilled.
+     *
+     * @return False if the state couldn't be read, the command is left without it.
+     */
+    bool ensureResident(UndoCommand *command);
+
+    qint64 getResidentBytes() const { return mResidentBytes; }
+    qint64 getSpilledBytes() const { return mSpilledBytes; }
+
+private:
+    UndoMemoryManager() = default;
+    UndoMemoryManager(const UndoMemoryManager&) = delete;
+    UndoMemoryManager& operator=(const UndoMemoryManager&) = delete;
+
+    struct Entry
+    {
+        UndoCommand *command;
+        qint64 bytes; /**< Memory used while resident. */
+        qint64 offset; /**< Position in spill file, -1 if resident. */
+        qint64 size;
+    };
+
+    struct Extent
+    {
+        qint64 offset;
+        qint64 size;
+    };
+
+    int indexOf(const UndoCommand *command) const;
+    void enforceBudget(const UndoCommand *keep);
+    bool spill(Entry &entry);
+    /**
+     * @brief Find place for state in spill file, reusing space of freed states first.
+     */
+    qint64 allocateExtent(qint64 size);
+    /**
+     * @brief Mark range of spill file as reusable, the file is truncated if it is at the end.
+     */
+    void freeExtent(qint64 offset, qint64 size);
+
+    QList<Entry> mEntries; /**< Least recently used first. */
+    qint64 mResidentBytes = 0;
+    qint64 mSpilledBytes = 0;
+    QTemporaryFile mSpillFile;
+    QList<Extent> mFreeExtents; /**< Unused ranges of spill file, sorted by offset and never adjacent. */
+};
@@ -30,6 +30,7 @@
 #include <QToolButton>
 #include <QGridLayout>
 #include <QSpinBox>
+#include <QCheckBox>
 #include <QAction>
 #include <QtCore/QMap>
 
@@ -101,11 +102,26 @@ void ToolBar::initializeItems()
     penSizeSpin->setToolTip(tr("Pen size"));
     connect(penSizeSpin, SIGNAL(valueChanged(int)), this, SLOT(penValueChanged(int)));
 
+    QSpinBox *fillToleranceSpin = new QSpinBox();
+    fillToleranceSpin->setRange(0, 255);
+    fillToleranceSpin->setValue(DataSingleton::Instance()->getFillTolerance());
+    fillToleranceSpin->setStatusTip(tr("Fill tolerance"));
+    fillToleranceSpin->setToolTip(tr("Fill tolerance"));
+    connect(fillToleranceSpin, SIGNAL(valueChanged(int)), this, SLOT(fillToleranceChanged(int)));
+
+    QCheckBox *fillConnectivityCheck = new QCheckBox(tr("8-way"));
+    fillConnectivityCheck->setChecked(DataSingleton::Instance()->getIsFillEightConnected());
+    fillConnectivityCheck->setStatusTip(tr("Fill through diagonal neighbours"));
+    fillConnectivityCheck->setToolTip(tr("Fill through diagonal neighbours"));
+    connect(fillConnectivityCheck, SIGNAL(toggled(bool)), this, SLOT(fillConnectivityChanged(bool)));
+
     QGridLayout *tLayout = new QGridLayout();
     tLayout->setContentsMargins(3, 3, 3, 3);
     tLayout->addWidget(mPColorChooser, 0, 0);
     tLayout->addWidget(mSColorChooser, 0, 1);
     tLayout->addWidget(penSizeSpin, 1, 0, 1, 2);
+    tLayout->addWidget(fillToleranceSpin, 2, 0, 1, 2);
+    tLayout->addWidget(fillConnectivityCheck, 3, 0, 1, 2);
 
     QWidget *tWidget = new QWidget();
     tWidget->setLayout(tLayout);
@@ -120,6 +136,16 @@ void ToolBar::penValueChanged(const int &value)
     DataSingleton::Instance()->setPenSize(value);
 }
 
+void ToolBar::fillToleranceChanged(const int &value)
+{
+    DataSingleton::Instance()->setFillTolerance(value);
+}
+
+void ToolBar::fillConnectivityChanged(bool isEightConnected)
+{
+    DataSingleton::Instance()->setIsFillEightConnected(isEightConnected);
+}
+
 void ToolBar::primaryColorChanged(const QColor &color)
 {
     DataSingleton::Instance()->setPrimaryColor(color);
@@ -78,6 +78,8 @@ public slots:
     
 private slots:
     void penValueChanged(const int &value);
+    void fillToleranceChanged(const int &value);
+    void fillConnectivityChanged(bool isEightConnected);
     void primaryColorChanged(const QColor &color);
     void secondaryColorChanged(const QColor &color);
 
@@ -0,0 +1,56 @@
+#include "sources/instruments/floodfill.h"
+
+#include <QtTest>
+
+/**
+ * @brief Iterative scanline fill of a whole 10000 x 10000 canvas.
+ */
+class FloodFillBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void fill_data();
+    void fill();
+
+private:
+    QImage mImage;
+};
+
+void FloodFillBenchmark::initTestCase()
+{
+    mImage = QImage(10000, 10000, QImage::Format_ARGB32_Premultiplied);
+    QVERIFY(!mImage.isNull());
+    mImage.fill(Qt::white);
+}
+
+void FloodFillBenchmark::fill_data()
+{
+    QTest::addColumn<int>("tolerance");
+    QTest::addColumn<bool>("isEightConnected");
+
+    QTest::newRow("4-connected") << 0 << false;
+    QTest::newRow("8-connected") << 0 << true;
+    QTest::newRow("4-connected, tolerance 32") << 32 << false;
+    QTest::newRow("8-connected, tolerance 32") << 32 << true;
+}
+
+void FloodFillBenchmark::fill()
+{
+    QFETCH(int, tolerance);
+    QFETCH(bool, isEightConnected);
+
+    // Swap colors on every run, so each one floods the whole canvas again
+    QRect rect;
+    QBENCHMARK
+    {
+        const QRgb color = mImage.pixel(0, 0) == qRgb(255, 255, 255) ? qRgb(0, 0, 0) : qRgb(255, 255, 255);
+        rect = floodFill(mImage, QPoint(5000, 5000), color, tolerance, isEightConnected);
+    }
+    QCOMPARE(rect, mImage.rect());
+}
+
+QTEST_GUILESS_MAIN(FloodFillBenchmark)
+
+#include "bench_floodfill.moc"
@@ -0,0 +1,73 @@
+#include "sources/imageresize.h"
+#include "sources/cpufeatures.h"
+
+#include <QtTest>
+
+Q_DECLARE_METATYPE(CpuFeatures::Level)
+
+/**
+ * @brief The same AVIR resize with scalar, SSE and AVX float types.
+ */
+class ImageResizeBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void resize_data();
+    void resize();
+
+private:
+    QImage mImage;
+};
+
+void ImageResizeBenchmark::initTestCase()
+{
+    // Gradient with some texture, flat images would hide filter cost
+    mImage = QImage(4000, 3000, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < mImage.height(); ++y)
+    {
+        QRgb *row = reinterpret_cast<QRgb*>(mImage.scanLine(y));
+        for (int x = 0; x < mImage.width(); ++x)
+            row[x] = qRgb(x & 0xff, y & 0xff, (x ^ y) & 0xff);
+    }
+}
+
+void ImageResizeBenchmark::cleanup()
+{
+    CpuFeatures::setMaxLevel(CpuFeatures::AVX2);
+}
+
+void ImageResizeBenchmark::resize_data()
+{
+    QTest::addColumn<CpuFeatures::Level>("level");
+
+    QTest::newRow("scalar") << CpuFeatures::SCALAR;
+    QTest::newRow("sse2") << CpuFeatures::SSE2;
+    QTest::newRow("avx") << CpuFeatures::AVX;
+}
+
+void ImageResizeBenchmark::resize()
+{
+    QFETCH(CpuFeatures::Level, level);
+
+    if ((level >= CpuFeatures::SSE2 && !CpuFeatures::hasSse2())
+            || (level >= CpuFeatures::AVX && !CpuFeatures::hasAvx()))
+    {
+        QSKIP("CPU doesn't support this code path");
+    }
+    CpuFeatures::setMaxLevel(level);
+
+    const QSize newSize(1600, 1200);
+    QImage result;
+    QBENCHMARK
+    {
+        result = ImageResize::resize(mImage, newSize, ImageResize::QUALITY);
+    }
+    QCOMPARE(result.size(), newSize);
+}
+
+QTEST_GUILESS_MAIN(ImageResizeBenchmark)
+
+#include "bench_imageresize.moc"
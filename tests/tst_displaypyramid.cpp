@@ -0,0 +1,137 @@
+#include "sources/displaypyramid.h"
+
+#include <QtTest>
+
+/**
+ * @brief Level selection, box filtering and invalidation of DisplayPyramid.
+ */
+class DisplayPyramidTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void levelForZoom_data();
+    void levelForZoom();
+    void halvesByAveraging();
+    void clampsOddEdges();
+    void staysStaleUntilInvalidated();
+    void resetsOnSizeChange();
+};
+
+namespace {
+
+/**
+ * @brief Opaque image with red channel of each pixel taken from values, row by row.
+ */
+QImage makeImage(int width, int height, const QVector<int> &values)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+            image.setPixel(x, y, qRgb(values.at(y * width + x), 0, 0));
+    }
+    return image;
+}
+
+int redAt(const QImage &image, int x, int y)
+{
+    return qRed(image.pixel(x, y));
+}
+
+}
+
+void DisplayPyramidTest::levelForZoom_data()
+{
+    QTest::addColumn<qreal>("zoomFactor");
+    QTest::addColumn<int>("level");
+
+    QTest::newRow("zoomed in") << 2.0 << 0;
+    QTest::newRow("actual size") << 1.0 << 0;
+    QTest::newRow("between 1/2 and 1") << 0.75 << 0;
+    QTest::newRow("1/2") << 0.5 << 1;
+    QTest::newRow("between 1/4 and 1/2") << 0.3 << 1;
+    QTest::newRow("1/4") << 0.25 << 2;
+    QTest::newRow("1/8") << 0.125 << 3;
+    QTest::newRow("below 1/8") << 0.0625 << 3;
+}
+
+void DisplayPyramidTest::levelForZoom()
+{
+    QFETCH(qreal, zoomFactor);
+    QFETCH(int, level);
+
+    QCOMPARE(DisplayPyramid::levelForZoom(zoomFactor), level);
+}
+
+void DisplayPyramidTest::halvesByAveraging()
+{
+    const QImage source = makeImage(4, 4, {   0, 100,  10,  10,
+                                            200,  40,  10,  10,
+                                            255, 255,   1,   2,
+                                            255, 255,   3,   4 });
+    DisplayPyramid pyramid;
+
+    const QImage level1 = pyramid.getLevel(source, 1, source.rect());
+    QCOMPARE(level1.size(), QSize(2, 2));
+    // Rounded to nearest: (0 + 100 + 200 + 40 + 2) / 4
+    QCOMPARE(redAt(level1, 0, 0), 85);
+    QCOMPARE(redAt(level1, 1, 0), 10);
+    QCOMPARE(redAt(level1, 0, 1), 255);
+    QCOMPARE(redAt(level1, 1, 1), 3);
+    QCOMPARE(qAlpha(level1.pixel(0, 0)), 255);
+
+    // Built from the level above, not from the source
+    const QImage level2 = pyramid.getLevel(source, 2, source.rect());
+    QCOMPARE(level2.size(), QSize(1, 1));
+    QCOMPARE(redAt(level2, 0, 0), (85 + 10 + 255 + 3 + 2) / 4);
+}
+
+void DisplayPyramidTest::clampsOddEdges()
+{
+    const QImage source = makeImage(3, 3, {  0,   0, 100,
+                                             0,   0, 200,
+                                            50,  70,  90 });
+    DisplayPyramid pyramid;
+
+    const QImage level1 = pyramid.getLevel(source, 1, source.rect());
+    QCOMPARE(level1.size(), QSize(2, 2));
+    QCOMPARE(redAt(level1, 1, 0), (100 + 100 + 200 + 200 + 2) / 4);
+    QCOMPARE(redAt(level1, 0, 1), (50 + 70 + 50 + 70 + 2) / 4);
+    QCOMPARE(redAt(level1, 1, 1), 90);
+}
+
+void DisplayPyramidTest::staysStaleUntilInvalidated()
+{
+    QImage source = makeImage(4, 4, QVector<int>(16, 0));
+    DisplayPyramid pyramid;
+    QCOMPARE(redAt(pyramid.getLevel(source, 2, source.rect()), 0, 0), 0);
+
+    source.setPixel(0, 0, qRgb(252, 0, 0));
+    QCOMPARE(redAt(pyramid.getLevel(source, 1, source.rect()), 0, 0), 0);
+    QCOMPARE(redAt(pyramid.getLevel(source, 2, source.rect()), 0, 0), 0);
+
+    pyramid.invalidate(QRect(0, 0, 1, 1));
+    // Requesting the lower level first has to rebuild the upper one as well
+    QCOMPARE(redAt(pyramid.getLevel(source, 2, source.rect()), 0, 0), 16);
+    QCOMPARE(redAt(pyramid.getLevel(source, 1, source.rect()), 0, 0), 63);
+    QCOMPARE(redAt(pyramid.getLevel(source, 1, source.rect()), 1, 1), 0);
+}
+
+void DisplayPyramidTest::resetsOnSizeChange()
+{
+    DisplayPyramid pyramid;
+    const QImage small = makeImage(2, 2, QVector<int>(4, 0));
+    QCOMPARE(pyramid.getLevel(small, 1, small.rect()).size(), QSize(1, 1));
+
+    // No invalidate() call, the new size alone drops the old levels
+    const QImage large = makeImage(4, 2, QVector<int>(8, 200));
+    const QImage level1 = pyramid.getLevel(large, 1, large.rect());
+    QCOMPARE(level1.size(), QSize(2, 1));
+    QCOMPARE(redAt(level1, 0, 0), 200);
+    QCOMPARE(redAt(level1, 1, 0), 200);
+}
+
+QTEST_GUILESS_MAIN(DisplayPyramidTest)
+
+#include "tst_displaypyramid.moc"
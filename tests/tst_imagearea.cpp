@@ -0,0 +1,124 @@
+#include "sources/imagearea.h"
+
+#include <QtTest>
+#include <QApplication>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <memory>
+
+class ImageAreaTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void saveReportsSuccess();
+    void saveReportsFailure();
+    void mapsPixelsBothWays_data();
+    void mapsPixelsBothWays();
+
+private:
+    /**
+     * @brief Write small image to file and open it in image area, waiting until it is loaded.
+     */
+    std::unique_ptr<ImageArea> openImage(const QString &filePath);
+};
+
+void ImageAreaTest::initTestCase()
+{
+    // Keep settings written by image area (last file path) away from the user's ones
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+std::unique_ptr<ImageArea> ImageAreaTest::openImage(const QString &filePath)
+{
+    QImage image(16, 16, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+    if (!image.save(filePath))
+        return nullptr;
+
+    std::unique_ptr<ImageArea> imageArea(new ImageArea(true, false, filePath, nullptr));
+    QSignalSpy loadingSpy(imageArea.get(), SIGNAL(sendLoadingFinished(bool)));
+    if (!loadingSpy.wait() || !loadingSpy.first().first().toBool())
+        return nullptr;
+    return imageArea;
+}
+
+void ImageAreaTest::saveReportsSuccess()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath("image.png");
+    auto imageArea = openImage(filePath);
+    QVERIFY(imageArea);
+
+    QVERIFY(imageArea->save());
+    QVERIFY(!QImage(filePath).isNull());
+}
+
+void ImageAreaTest::saveReportsFailure()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto imageArea = openImage(dir.filePath("image.png"));
+    QVERIFY(imageArea);
+    // Nothing can be written once the directory is gone, even for root
+    QVERIFY(dir.remove());
+
+    // save() shows a warning on failure, dismiss it
+    QTimer closer;
+    connect(&closer, &QTimer::timeout, [] {
+        if (QWidget *dialog = QApplication::activeModalWidget())
+            dialog->close();
+    });
+    closer.start(50);
+
+    QVERIFY(!imageArea->save());
+}
+
+void ImageAreaTest::mapsPixelsBothWays_data()
+{
+    QTest::addColumn<qreal>("zoomFactor");
+    QTest::addColumn<QPoint>("scrollOffset");
+
+    QTest::newRow("actual size") << 1.0 << QPoint(0, 0);
+    QTest::newRow("actual size, scrolled") << 1.0 << QPoint(13, 5);
+    QTest::newRow("1.25, scrolled") << 1.25 << QPoint(13, 5);
+    QTest::newRow("1.5, scrolled") << 1.5 << QPoint(7, 21);
+    QTest::newRow("2.5, scrolled") << 2.5 << QPoint(3, 8);
+    QTest::newRow("1.1 cubed, scrolled") << 1.1 * 1.1 * 1.1 << QPoint(11, 2);
+    QTest::newRow("3, scrolled") << 3.0 << QPoint(30, 1);
+}
+
+void ImageAreaTest::mapsPixelsBothWays()
+{
+    QFETCH(qreal, zoomFactor);
+    QFETCH(QPoint, scrollOffset);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto imageArea = openImage(dir.filePath("image.png"));
+    QVERIFY(imageArea);
+    if (!qFuzzyCompare(zoomFactor, 1.0))
+        QVERIFY(imageArea->setZoomFactor(zoomFactor));
+    imageArea->setScrollOffset(scrollOffset);
+
+    // Zoomed out several pixels share one widget pixel, so only zoom 1 and above maps back
+    for (int y = 0; y < 16; ++y)
+    {
+        for (int x = 0; x < 16; ++x)
+        {
+            const QPoint pixel(x, y);
+            const QPoint widgetPos = imageArea->mapFromImage(pixel);
+            QCOMPARE(imageArea->mapToImage(widgetPos), pixel);
+            // Top left corner: the widget pixel before it shows the previous image pixel
+            QCOMPARE(imageArea->mapToImage(widgetPos - QPoint(1, 1)), pixel - QPoint(1, 1));
+        }
+    }
+}
+
+QTEST_MAIN(ImageAreaTest)
+
+#include "tst_imagearea.moc"